@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <generated/csr.h>
+#include <generated/mem.h>
+
+#include "autorun.h"
+#include "command.h"
+#include "sched.h"
+#include "uartx.h"
+
+#if defined(ROM_BASE) && defined(ROM_SIZE)
+
+/* The script sector sits just past the rom region in the XIP window. */
+#define AUTORUN_ADDR  (ROM_BASE + ROM_SIZE)
+#define AUTORUN_MAGIC "ARUN"
+#define AUTORUN_MAX   256
+
+void autorun_exec(void)
+{
+	const char *flash = (const char *)AUTORUN_ADDR;
+	static char script[AUTORUN_MAX];
+	char *line, *next;
+	unsigned int deadline;
+	int i;
+
+	if(memcmp(flash, AUTORUN_MAGIC, 4) != 0)
+		return;
+
+	/* Copy out of flash (erased/garbage bytes end the script). */
+	flash += 4;
+	for(i = 0; i < AUTORUN_MAX - 1; i++) {
+		char c = flash[i];
+		if(c == 0 || (unsigned char)c == 0xff)
+			break;
+		script[i] = c;
+	}
+	script[i] = 0;
+	if(i == 0)
+		return;
+
+	printf("autorun: \"%s\" (press any key to skip)\n", script);
+
+	/* Escape hatch: half a second to grab the console instead. */
+#ifdef CSR_TIMER0_BASE
+	uartx_rx_raw(1);
+	deadline = sched_ticks() + 30;
+	while((int)(deadline - sched_ticks()) > 0) {
+		if(uartx_getchar() >= 0) {
+			uartx_rx_raw(0);
+			printf("autorun: skipped.\n");
+			return;
+		}
+	}
+	uartx_rx_raw(0);
+#else
+	(void)deadline;
+#endif
+
+	/* One command per line; ';' also separates commands. */
+	line = script;
+	while(line != NULL && *line != 0) {
+		next = strpbrk(line, "\n;");
+		if(next != NULL)
+			*next++ = 0;
+		cmd_exec(line);
+		line = next;
+	}
+}
+
+#else /* no rom region: nothing to read the script from */
+
+void autorun_exec(void) {}
+
+#endif
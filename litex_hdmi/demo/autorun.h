@@ -0,0 +1,13 @@
+#ifndef __AUTORUN_H
+#define __AUTORUN_H
+
+/* Headless boot: main() runs the command script stored in flash right
+ * after the 64KB rom region ("ARUN" magic + NUL-terminated commands,
+ * one per line or ';'-separated) before dropping into the console.
+ * Build the blob with 'make autorun.bin' and flash it at
+ * bios_flash_offset + 0x10000. A key press during the grace period
+ * skips straight to the interactive prompt. */
+
+void autorun_exec(void);
+
+#endif /* __AUTORUN_H */
@@ -0,0 +1,8 @@
+#ifndef __BENCH_H
+#define __BENCH_H
+
+/* CPU/memory/CSR microbenchmark suite for the bench console command. */
+
+void bench(void);
+
+#endif /* __BENCH_H */
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "command.h"
+
+/* Table bounds provided by linker.ld (.cmdtab, sorted by name). */
+extern const struct command _fcmdtab[], _ecmdtab[];
+
+/* First-character buckets over the sorted table: dispatch is one index
+ * plus a strcmp or two within the bucket, independent of how many
+ * commands are registered. Built lazily on the first lookup. */
+static unsigned char bucket_lo[128];
+static unsigned char bucket_hi[128];
+static int buckets_ready;
+
+static void build_buckets(void)
+{
+	int n = _ecmdtab - _fcmdtab;
+	int i, c;
+
+	for(c = 0; c < 128; c++) {
+		bucket_lo[c] = n;
+		bucket_hi[c] = n;
+	}
+	for(i = 0; i < n; i++) {
+		c = _fcmdtab[i].name[0] & 0x7f;
+		if(bucket_lo[c] == n)
+			bucket_lo[c] = i;
+		bucket_hi[c] = i + 1;
+	}
+	buckets_ready = 1;
+}
+
+const struct command *cmd_find(const char *name)
+{
+	int c, i;
+
+	if(!buckets_ready)
+		build_buckets();
+
+	c = name[0] & 0x7f;
+	for(i = bucket_lo[c]; i < bucket_hi[c]; i++) {
+		if(strcmp(_fcmdtab[i].name, name) == 0)
+			return &_fcmdtab[i];
+	}
+	return NULL;
+}
+
+void cmd_help(void)
+{
+	const struct command *cmd;
+
+	for(cmd = _fcmdtab; cmd < _ecmdtab; cmd++)
+		printf("%-18s - %s\n", cmd->name, cmd->help);
+}
+
+char *get_token(char **str)
+{
+	char *c, *d;
+
+	c = (char *)strchr(*str, ' ');
+	if(c == NULL) {
+		d = *str;
+		*str = *str+strlen(*str);
+		return d;
+	}
+	*c = 0;
+	d = *str;
+	*str = c+1;
+	return d;
+}
+
+/* Tokenizes and dispatches one command line; shared by the console loop
+ * and the flash autorun path. */
+void cmd_exec(char *line)
+{
+	const struct command *cmd;
+	char *token;
+
+	token = get_token(&line);
+	if(*token == 0)
+		return;
+	cmd = cmd_find(token);
+	if(cmd != NULL)
+		cmd->handler(line);
+	else
+		printf("Command not found: '%s'\n", token);
+}
@@ -0,0 +1,27 @@
+#ifndef __COMMAND_H
+#define __COMMAND_H
+
+/* Console command registry. Commands self-register with REGISTER_CMD();
+ * the entries land in a linker section sorted by name, and cmd_find()
+ * dispatches through per-first-character buckets, so lookup cost stays
+ * flat however many commands get added. The handler receives whatever
+ * followed the command name on the line. */
+
+struct command {
+	const char *name;
+	void (*handler)(char *args);
+	const char *help;
+};
+
+#define REGISTER_CMD(cmd_name, cmd_handler, cmd_help) \
+	static const struct command cmd_entry_##cmd_handler \
+	__attribute__((used, aligned(4), section(".cmdtab." #cmd_name))) = { \
+		#cmd_name, cmd_handler, cmd_help \
+	}
+
+const struct command *cmd_find(const char *name);
+void cmd_help(void);
+void cmd_exec(char *line);
+char *get_token(char **str);
+
+#endif /* __COMMAND_H */
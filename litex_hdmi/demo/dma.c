@@ -0,0 +1,97 @@
+#include <string.h>
+
+#include <generated/csr.h>
+
+#include "dma.h"
+
+#ifdef CSR_DMA_BASE
+
+#define DMA_MODE_COPY 0
+#define DMA_MODE_FILL 1
+
+#define DMA_ALIGNED(p) (((uintptr_t)(p) & 3) == 0)
+
+void dma_wait(void)
+{
+	while(!dma_done_read());
+}
+
+void dma_memcpy(void *dst, const void *src, size_t n)
+{
+	size_t words = n & ~(size_t)3;
+
+	if(words && DMA_ALIGNED(dst) && DMA_ALIGNED(src)) {
+		dma_wait();
+		dma_src_write((uintptr_t)src);
+		dma_dst_write((uintptr_t)dst);
+		dma_length_write(words);
+		dma_mode_write(DMA_MODE_COPY);
+		dma_start_write(1);
+		dma_wait();
+		dst = (char *)dst + words;
+		src = (const char *)src + words;
+		n  -= words;
+	}
+	if(n)
+		memcpy(dst, src, n);
+}
+
+int dma_memcpy_async(void *dst, const void *src, size_t n)
+{
+	if((n & 3) || !DMA_ALIGNED(dst) || !DMA_ALIGNED(src)) {
+		memcpy(dst, src, n);
+		return 0;
+	}
+	dma_wait();
+	dma_src_write((uintptr_t)src);
+	dma_dst_write((uintptr_t)dst);
+	dma_length_write(n);
+	dma_mode_write(DMA_MODE_COPY);
+	dma_start_write(1);
+	return 1;
+}
+
+void dma_memset(void *dst, int c, size_t n)
+{
+	size_t words = n & ~(size_t)3;
+	uint32_t v = (uint8_t)c;
+
+	v |= v << 8;
+	v |= v << 16;
+
+	if(words && DMA_ALIGNED(dst)) {
+		dma_wait();
+		dma_dst_write((uintptr_t)dst);
+		dma_length_write(words);
+		dma_fill_value_write(v);
+		dma_mode_write(DMA_MODE_FILL);
+		dma_start_write(1);
+		dma_wait();
+		dst = (char *)dst + words;
+		n  -= words;
+	}
+	if(n)
+		memset(dst, c, n);
+}
+
+#else /* !CSR_DMA_BASE */
+
+void dma_wait(void) {}
+
+void dma_memcpy(void *dst, const void *src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+int dma_memcpy_async(void *dst, const void *src, size_t n)
+{
+	memcpy(dst, src, n);
+	return 0;
+}
+
+void dma_memset(void *dst, int c, size_t n)
+{
+	memset(dst, c, n);
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef __DMA_H
+#define __DMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Firmware wrappers for the WishboneDMA copy/fill engine. Both calls fall
+ * back to the CPU memcpy/memset when the engine is absent or the buffers
+ * are not word-aligned, so callers can use them unconditionally. */
+
+void dma_memcpy(void *dst, const void *src, size_t n);
+void dma_memset(void *dst, int c, size_t n);
+void dma_wait(void);
+
+/* Starts the copy and returns immediately so the CPU can keep working;
+ * returns 0 (after a blocking CPU copy) when the engine can't take it.
+ * Callers must dma_wait() before touching either buffer again. */
+int dma_memcpy_async(void *dst, const void *src, size_t n);
+
+#endif /* __DMA_H */
@@ -7,9 +7,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <libbase/console.h>
+#include <generated/csr.h>
+#include <generated/mem.h>
+
+#include "dma.h"
+#include "fastcode.h"
+#include "prof.h"
+#include "uartx.h"
 
 #define R(mul,shift,x,y) \
   _=x; \
@@ -19,50 +27,199 @@
   x = x*_>>10; \
   y = y*_>>10;
 
-signed char b[1760], z[1760];
+// Double-buffered character frames: the renderer fills the back buffer
+// (b) while the TX engine -- UART ring or DMA -- still drains the front
+// one, so frame rate is set by the slowest stage instead of their sum.
+// The z buffer is only live during a render, one copy is enough.
+static signed char fb_buf[2][1760];
+static signed char *b = fb_buf[0];
+static signed char z[1760];
+
+// Previous transmitted frame for the delta encoder. Kept in main_ram to
+// leave sram room for the FASTCODE routines (it's only read sequentially).
+static signed char prev[1760] __attribute__((section(".mainram_bss")));
+static int prev_valid;
+
+// Reciprocal LUT for the projection divides. On a VexRiscv without the M
+// extension each /x6 is a multi-hundred-cycle soft-div and the inner loop
+// does two of them per sample (90*324 samples per frame). x6 stays in
+// (0, 2*K2), so a table of 1/x6 in Q31, indexed by x6>>13 (0.4% worst-case
+// step error, well under half a character cell), turns each divide into
+// one multiply. The table is filled once, with one real divide per entry.
+#define RECIP_SHIFT 13
+#define RECIP_SIZE  ((2*5120*1024 >> RECIP_SHIFT) + 1)
+
+// Lives in main_ram: 5KB doesn't fit next to the frame buffers in sram.
+static uint32_t recip_lut[RECIP_SIZE] __attribute__((section(".mainram_bss")));
+static int recip_ready;
+
+static void recip_init(void) {
+  for (int i = 0; i < RECIP_SIZE; i++)
+    recip_lut[i] = (1u << 31) / ((i << RECIP_SHIFT) + (1 << (RECIP_SHIFT - 1)));
+  recip_ready = 1;
+}
+
+// num/den for den in (0, 2*K2), via the LUT.
+static inline int recip_div(int num, int den) {
+  return (int)(((int64_t)num * recip_lut[den >> RECIP_SHIFT]) >> 31);
+}
+
+// Rotation state, shared by the UART and HDMI variants.
+static int sA=1024, cA=0, sB=1024, cB=0;
 
 void donut(void);
-void donut(void) {
-  int sA=1024,cA=0,sB=1024,cB=0,_;
-  for (;;) {
-    memset(b, 32, 1760);  // text buffer
-    memset(z, 127, 1760);   // z buffer
-    int sj=0, cj=1024;
-    for (int j = 0; j < 90; j++) {
-      int si = 0, ci = 1024;  // sine and cosine of angle i
-      for (int i = 0; i < 324; i++) {
-        int R1 = 1, R2 = 2048, K2 = 5120*1024;
-
-        int x0 = R1*cj + R2,
-            x1 = ci*x0 >> 10,
-            x2 = cA*sj >> 10,
-            x3 = si*x0 >> 10,
-            x4 = R1*x2 - (sA*x3 >> 10),
-            x5 = sA*sj >> 10,
-            x6 = K2 + R1*1024*x5 + cA*x3,
-            x7 = cj*si >> 10,
-            x = 40 + 30*(cB*x1 - sB*x4)/x6,
-            y = 12 + 15*(cB*x4 + sB*x1)/x6,
-            N = (-cA*x7 - cB*((-sA*x7>>10) + x2) - ci*(cj*sB >> 10) >> 10) - x5 >> 7;
-
-        int o = x + 80 * y;
-        signed char zz = (x6-K2)>>15;
-        if (22 > y && y > 0 && x > 0 && 80 > x && zz < z[o]) {
-          z[o] = zz;
-          b[o] = ".,-~:;=!*#$@"[N > 0 ? N : 0];
+void donut_hdmi(void);
+
+// Render one frame of the donut into b[] (and z[]), then advance the
+// rotation. Output is left to the caller so the same renderer can feed
+// the UART or the HDMI character framebuffer. FASTCODE: this is the
+// hottest loop in the firmware, run it from sram.
+static FASTCODE void donut_frame(void) {
+  int _;
+  if (!recip_ready)
+    recip_init();
+  PROF_ENTER(PROF_DONUT_CLEAR, "donut.clear");
+  memset(b, 32, 1760);  // text buffer
+  memset(z, 127, 1760);   // z buffer
+  PROF_EXIT(PROF_DONUT_CLEAR);
+  int sj=0, cj=1024;
+  for (int j = 0; j < 90; j++) {
+    PROF_ENTER(PROF_DONUT_INNER, "donut.inner");
+    int si = 0, ci = 1024;  // sine and cosine of angle i
+    for (int i = 0; i < 324; i++) {
+      int R1 = 1, R2 = 2048, K2 = 5120*1024;
+
+      int x0 = R1*cj + R2,
+          x1 = ci*x0 >> 10,
+          x2 = cA*sj >> 10,
+          x3 = si*x0 >> 10,
+          x4 = R1*x2 - (sA*x3 >> 10),
+          x5 = sA*sj >> 10,
+          x6 = K2 + R1*1024*x5 + cA*x3,
+          x7 = cj*si >> 10,
+          x = 40 + recip_div(30*(cB*x1 - sB*x4), x6),
+          y = 12 + recip_div(15*(cB*x4 + sB*x1), x6),
+          N = (-cA*x7 - cB*((-sA*x7>>10) + x2) - ci*(cj*sB >> 10) >> 10) - x5 >> 7;
+
+      int o = x + 80 * y;
+      signed char zz = (x6-K2)>>15;
+      if (22 > y && y > 0 && x > 0 && 80 > x && zz < z[o]) {
+        z[o] = zz;
+        b[o] = ".,-~:;=!*#$@"[N > 0 ? N : 0];
+      }
+      R(5, 8, ci, si)  // rotate i
+    }
+    PROF_EXIT(PROF_DONUT_INNER);
+    R(9, 7, cj, sj)  // rotate j
+  }
+  R(5, 7, cA, sA);
+  R(5, 8, cB, sB);
+}
+
+// Swap front/back: returns the buffer just rendered and points the
+// renderer at the other one.
+static signed char *donut_swap(void) {
+  signed char *front = b;
+  b = (front == fb_buf[0]) ? fb_buf[1] : fb_buf[0];
+  return front;
+}
+
+// Full repaint: clear, draw the 22 rows and remember the frame.
+static void donut_tx_full(const signed char *f) {
+  uartx_puts("\x1b[2J\x1b[H");
+  for (int k = 0; 1760 > k; k++) {
+    uartx_putc(f[k]);
+    if (k % 80 == 79)
+      uartx_putc(10);
+  }
+  memcpy(prev, f, 1760);
+  prev_valid = 1;
+}
+
+// Delta frame: consecutive frames share most cells, so emit only
+// cursor-position + changed-run sequences. Gaps of up to 4 unchanged
+// cells are folded into a run (a cursor move costs ~8 bytes).
+static void donut_tx_delta(const signed char *f) {
+  char esc[16];
+  for (int y = 0; y < 22; y++) {
+    int base = y * 80;
+    int x = 0;
+    while (x < 80) {
+      if (f[base + x] == prev[base + x]) {
+        x++;
+        continue;
+      }
+      int end = x + 1;       // end of the run (exclusive)
+      int gap = 0;
+      for (int e = end; e < 80; e++) {
+        if (f[base + e] != prev[base + e]) {
+          end = e + 1;
+          gap = 0;
+        } else if (++gap > 4) {
+          break;
         }
-        R(5, 8, ci, si)  // rotate i
       }
-      R(9, 7, cj, sj)  // rotate j
+      snprintf(esc, sizeof(esc), "\x1b[%d;%dH", y + 1, x + 1);
+      uartx_puts(esc);
+      for (int e = x; e < end; e++)
+        uartx_putc(f[base + e]);
+      x = end;
     }
-    for (int k = 0; 1761 > k; k++)
-      putchar(k % 80 ? b[k] : 10);
-    R(5, 7, cA, sA);
-    R(5, 8, cB, sB);
-  	if (readchar_nonblock()) {
-  		getchar();
+  }
+  memcpy(prev, f, 1760);
+}
+
+void donut(void) {
+  prev_valid = 0;  // force an initial full repaint
+  uartx_rx_raw(1);  // poll raw keys; the line FIFO keeps batched input
+  for (;;) {
+    donut_frame();
+    // Swap and queue the finished frame in the TX ring: it drains from
+    // the UART interrupt while the next frame renders into the other
+    // buffer, instead of blocking per character.
+    signed char *front = donut_swap();
+    PROF_ENTER(PROF_DONUT_TX, "donut.tx");
+    if (prev_valid)
+      donut_tx_delta(front);
+    else
+      donut_tx_full(front);
+    PROF_EXIT(PROF_DONUT_TX);
+  	int c = uartx_getchar();
+  	if (c >= 0) {
+  		if (c == 'r') {          // full repaint on request
+  			prev_valid = 0;
+  			continue;
+  		}
+  		uartx_puts("\x1b[23;1H");
+  		uartx_flush();
   		break;
   	}
-    fputs("\x1b[23A", stdout);
   }
+  uartx_rx_raw(0);
+}
+
+#ifdef CSR_FB_BASE
+// HDMI variant: frames go straight into the character framebuffer in
+// HyperRAM (scanned out by the CharFramebuffer engine); the UART is only
+// polled for the exit key. Runs at whatever rate the renderer sustains.
+#define DONUT_FB_OFFSET 0x200000
+
+void donut_hdmi(void) {
+  char *fbmem = (char *)(MAIN_RAM_BASE + DONUT_FB_OFFSET);
+  fb_base_write(MAIN_RAM_BASE + DONUT_FB_OFFSET);
+  uartx_rx_raw(1);
+  for (;;) {
+    donut_frame();
+    // Previous DMA copy must be done before its source becomes the
+    // back buffer again; then stream the fresh frame to HyperRAM with
+    // the DMA engine while the CPU renders the next one.
+    dma_wait();
+    signed char *front = donut_swap();
+    dma_memcpy_async(fbmem, front, 1760);
+  	if (uartx_getchar() >= 0)
+  		break;
+  }
+  dma_wait();
+  uartx_rx_raw(0);
 }
+#endif
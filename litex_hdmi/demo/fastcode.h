@@ -0,0 +1,11 @@
+#ifndef __FASTCODE_H
+#define __FASTCODE_H
+
+/* Place a function in the .fastcode section: linked into sram (block RAM)
+ * and copied there at boot by the crt0 data-copy loop, so it executes at
+ * RAM speed instead of XIP-flash/HyperRAM speed. sram is 8KB and shared
+ * with .data/.bss and the stack -- reserve it for genuinely hot code. */
+
+#define FASTCODE __attribute__((section(".fastcode"), noinline))
+
+#endif /* __FASTCODE_H */
@@ -0,0 +1,136 @@
+#ifndef __FIXED_H
+#define __FIXED_H
+
+#include <stdint.h>
+
+/* Header-only fixed-point library for the WITH_CXX path (needs C++14 for
+ * relaxed constexpr). The trig/reciprocal tables are generated entirely at
+ * compile time, so they live in .rodata (XIP flash) with zero runtime
+ * initialization and no static constructors — renderers get LUT math for
+ * free on a core with no FPU and an expensive divider. */
+
+template<int I, int F>
+class fixed {
+	static_assert(I + F == 32, "fixed<I,F>: I+F must be 32");
+public:
+	constexpr fixed() : raw_(0) {}
+	constexpr fixed(int v) : raw_((int32_t)v << F) {}
+	/* Double math happens at compile time only. */
+	constexpr fixed(double v)
+		: raw_((int32_t)(v*(double)((int64_t)1 << F) + (v >= 0 ? 0.5 : -0.5))) {}
+
+	static constexpr fixed from_raw(int32_t r)
+	{
+		fixed f;
+		f.raw_ = r;
+		return f;
+	}
+
+	constexpr int32_t raw() const { return raw_; }
+	constexpr int to_int() const { return raw_ >> F; }
+	/* Milli-units, for printing without float support in printf. */
+	constexpr int to_milli() const
+	{
+		return (int)(((int64_t)raw_*1000) >> F);
+	}
+
+	constexpr fixed operator-() const { return from_raw(-raw_); }
+	constexpr fixed operator+(fixed o) const { return from_raw(raw_ + o.raw_); }
+	constexpr fixed operator-(fixed o) const { return from_raw(raw_ - o.raw_); }
+	constexpr fixed operator*(fixed o) const
+	{
+		return from_raw((int32_t)(((int64_t)raw_*o.raw_) >> F));
+	}
+	constexpr fixed operator/(fixed o) const
+	{
+		return from_raw((int32_t)(((int64_t)raw_ << F)/o.raw_));
+	}
+
+	constexpr bool operator==(fixed o) const { return raw_ == o.raw_; }
+	constexpr bool operator<(fixed o) const { return raw_ < o.raw_; }
+
+private:
+	int32_t raw_;
+};
+
+using fix16 = fixed<16, 16>; /* Q16.16, same scale donut.c uses */
+
+namespace fixtab {
+
+constexpr double PI = 3.14159265358979323846;
+
+/* Compile-time sine via Taylor series; |x| <= pi/2 keeps it accurate to
+ * well below one Q16.16 lsb with 6 terms. */
+constexpr double csin(double x)
+{
+	double term = x;
+	double sum  = x;
+	for(int n = 1; n < 6; n++) {
+		term = -term*x*x/((2*n)*(2*n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr int SIN_SIZE = 256; /* one full turn */
+
+struct sin_table_t {
+	int32_t v[SIN_SIZE];
+};
+
+constexpr sin_table_t make_sin_table()
+{
+	sin_table_t t{};
+	for(int i = 0; i < SIN_SIZE; i++) {
+		/* Fold to [-pi/2, pi/2] where the series converges fast. */
+		double a = 2.0*PI*i/SIN_SIZE;
+		double x = a;
+		if(a > PI/2 && a <= 3*PI/2)
+			x = PI - a;
+		else if(a > 3*PI/2)
+			x = a - 2*PI;
+		t.v[i] = fix16(csin(x)).raw();
+	}
+	return t;
+}
+
+constexpr int RECIP_SIZE = 256;
+
+struct recip_table_t {
+	int32_t v[RECIP_SIZE];
+};
+
+constexpr recip_table_t make_recip_table()
+{
+	recip_table_t t{};
+	t.v[0] = 0; /* 1/0: caller's problem, keep it harmless */
+	for(int i = 1; i < RECIP_SIZE; i++)
+		t.v[i] = (int32_t)((65536 + i/2)/i); /* round(2^16 / i) */
+	return t;
+}
+
+static constexpr sin_table_t   SIN_TAB   = make_sin_table();
+static constexpr recip_table_t RECIP_TAB = make_recip_table();
+
+} /* namespace fixtab */
+
+/* Angle is in turns (Q16.16: 1.0 == full circle), so wrap-around is free. */
+inline fix16 fix_sin(fix16 turns)
+{
+	return fix16::from_raw(
+		fixtab::SIN_TAB.v[(turns.raw() >> 8) & (fixtab::SIN_SIZE - 1)]);
+}
+
+inline fix16 fix_cos(fix16 turns)
+{
+	return fix16::from_raw(fixtab::SIN_TAB.v[
+		((turns.raw() >> 8) + fixtab::SIN_SIZE/4) & (fixtab::SIN_SIZE - 1)]);
+}
+
+/* 1/n for small integer n, one table read instead of a divide. */
+inline fix16 fix_recip(int n)
+{
+	return fix16::from_raw(fixtab::RECIP_TAB.v[n & (fixtab::RECIP_SIZE - 1)]);
+}
+
+#endif /* __FIXED_H */
@@ -1,7 +1,51 @@
 #include <stdio.h>
 
+#include "fixed.h"
+
+/* Exercises the constexpr fixed-point library (fixed.h): every table used
+ * below was generated at compile time, so there is nothing to initialize
+ * at boot and no static constructors in the binary. */
+
 extern "C" void hellocpp(void);
+
 void hellocpp(void)
 {
-    printf("C++: Hello, world!\n");
-}
\ No newline at end of file
+	printf("C++: fixed<16,16> demo (all tables built at compile time)\n");
+
+	/* Basic arithmetic: (3.5 * 2 - 1) / 4 = 1.5 */
+	constexpr fix16 r = (fix16(3.5)*fix16(2) - fix16(1))/fix16(4);
+	static_assert(r == fix16(1.5), "fixed-point arithmetic is constexpr");
+	printf("  (3.5 * 2 - 1) / 4 = %d.%03d\n",
+		r.to_int(), r.to_milli() - r.to_int()*1000);
+
+	/* Sweep the sine table and check sin^2 + cos^2 == 1 stays within a
+	 * couple of lsb of the Q16.16 representation. */
+	int max_err = 0;
+	for(int i = 0; i < 256; i++) {
+		fix16 a = fix16::from_raw(i << 8); /* i/256 turns */
+		fix16 s = fix_sin(a);
+		fix16 c = fix_cos(a);
+		int err = (s*s + c*c - fix16(1)).raw();
+		if(err < 0)
+			err = -err;
+		if(err > max_err)
+			max_err = err;
+	}
+	printf("  sin^2+cos^2 max error over full turn: %d lsb\n", max_err);
+
+	/* Reciprocal table: n * (1/n) for a few n. */
+	for(int n = 2; n <= 8; n *= 2) {
+		fix16 p = fix16(n)*fix_recip(n);
+		printf("  %d * recip(%d) = %d.%03d\n",
+			n, n, p.to_int(), p.to_milli() - p.to_int()*1000);
+	}
+
+	/* One turn of sine as an ASCII sparkline. */
+	printf("  sin: ");
+	for(int i = 0; i < 64; i++) {
+		static const char levels[] = " .:-=+*#";
+		int v = fix_sin(fix16::from_raw(i << 10)).to_milli(); /* -1000..1000 */
+		putchar(levels[(v + 1000)*7/2000]);
+	}
+	printf("\n");
+}
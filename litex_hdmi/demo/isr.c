@@ -0,0 +1,33 @@
+// Demo interrupt dispatcher: overrides the weak isr() from libbase so the
+// firmware can hook the timer (frame scheduler) next to the UART.
+
+#include <irq.h>
+#include <libbase/uart.h>
+#include <generated/csr.h>
+
+#include "sched.h"
+#include "uartx.h"
+
+#ifdef CONFIG_CPU_HAS_INTERRUPT
+
+void isr(void);
+void isr(void)
+{
+	unsigned int irqs;
+
+	irqs = irq_pending() & irq_getmask();
+
+#ifndef UART_POLLING
+	if(irqs & (1 << UART_INTERRUPT)) {
+		uart_isr();
+		uartx_isr_rx();
+		uartx_isr_tx();
+	}
+#endif
+#ifdef CSR_TIMER0_BASE
+	if(irqs & (1 << TIMER0_INTERRUPT))
+		sched_isr();
+#endif
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include <generated/csr.h>
+
+#include "led.h"
+#include "sched.h"
+
+#ifdef CSR_LEDS_BASE
+
+#define TICK_HZ 60 /* must match the sched_init() rate in main() */
+
+enum led_mode {
+	LED_OFF,
+	LED_COUNTER,
+	LED_FRAMES,
+};
+
+/* All state is only written with the mode forced to LED_OFF first, so the
+ * ISR never sees a half-updated program. */
+static volatile enum led_mode mode;
+static unsigned int div_ticks, div_cnt;
+static unsigned int step;
+static const uint8_t *frames;
+static int nframes, loop_anim;
+
+/* Called from sched_isr() on every system tick. */
+void led_anim_isr(void)
+{
+	if(mode == LED_OFF)
+		return;
+	if(++div_cnt < div_ticks)
+		return;
+	div_cnt = 0;
+
+	switch(mode) {
+	case LED_COUNTER:
+		leds_out_write(step++);
+		break;
+	case LED_FRAMES:
+		leds_out_write(frames[step]);
+		if(++step >= (unsigned int)nframes) {
+			step = 0;
+			if(!loop_anim) {
+				mode = LED_OFF;
+				leds_out_write(0);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void start(enum led_mode m, unsigned int ms)
+{
+	mode = LED_OFF;
+	div_ticks = ms*TICK_HZ/1000;
+	if(div_ticks == 0)
+		div_ticks = 1;
+	div_cnt = 0;
+	step = 0;
+	mode = m;
+}
+
+void led_anim_counter(unsigned int ms_per_step)
+{
+	start(LED_COUNTER, ms_per_step);
+}
+
+void led_anim_play(const uint8_t *f, int n, unsigned int ms_per_frame, int loop)
+{
+	mode = LED_OFF;
+	frames = f;
+	nframes = n;
+	loop_anim = loop;
+	start(LED_FRAMES, ms_per_frame);
+}
+
+/* The same patterns the old blocking led_cmd() stepped with busy_wait(). */
+static const uint8_t shift_frames[] = {
+	0x01, 0x02, 0x04, 0x08, 0x08, 0x04, 0x02, 0x01,
+};
+static const uint8_t dance_frames[] = {
+	0x55, 0xaa,
+};
+
+void led_anim_shift(void)
+{
+	led_anim_play(shift_frames, sizeof(shift_frames), 200, 1);
+}
+
+void led_anim_dance(void)
+{
+	led_anim_play(dance_frames, sizeof(dance_frames), 200, 1);
+}
+
+void led_anim_stop(void)
+{
+	mode = LED_OFF;
+	leds_out_write(0);
+}
+
+#else /* !CSR_LEDS_BASE */
+
+void led_anim_counter(unsigned int ms_per_step) { (void)ms_per_step; }
+void led_anim_play(const uint8_t *f, int n, unsigned int ms_per_frame, int loop)
+{
+	(void)f; (void)n; (void)ms_per_frame; (void)loop;
+}
+void led_anim_shift(void) {}
+void led_anim_dance(void) {}
+void led_anim_stop(void) {}
+void led_anim_isr(void) {}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef __LED_H
+#define __LED_H
+
+#include <stdint.h>
+
+/* Background LED animation engine: the console enqueues a pattern program
+ * and led_anim_isr() steps it from the timer tick, so the LEDs animate
+ * continuously while console_service() keeps handling commands. */
+
+void led_anim_counter(unsigned int ms_per_step);
+void led_anim_play(const uint8_t *frames, int nframes,
+                   unsigned int ms_per_frame, int loop);
+void led_anim_shift(void);
+void led_anim_dance(void);
+void led_anim_stop(void);
+void led_anim_isr(void);
+
+#endif /* __LED_H */
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Empaqueta un binario de firmware en formato bloque LZ4 para el boot stub.
+
+Salida: cabecera de 16 bytes {magic "LZ4B", tamano original, tamano
+comprimido, reservado} seguida de un unico bloque LZ4. Compresor greedy
+autocontenido (sin dependencias) compatible con el descompresor del stub.
+"""
+
+import argparse
+import struct
+
+MAGIC = b"LZ4B"
+
+MIN_MATCH = 4
+HASH_LOG  = 14
+
+
+def _hash(v):
+    return ((v * 2654435761) & 0xffffffff) >> (32 - HASH_LOG)
+
+
+def lz4_compress(src):
+    n = len(src)
+    table = {}
+    out = bytearray()
+    anchor = 0
+    i = 0
+    # Los ultimos 12 bytes deben ir como literales (regla del formato LZ4).
+    limit = n - 12
+
+    def emit(literals, match_len, offset):
+        lit_len = len(literals)
+        token_lit = min(lit_len, 15)
+        token_mat = min(match_len - MIN_MATCH, 15) if offset else 0
+        out.append((token_lit << 4) | token_mat)
+        rest = lit_len - 15
+        while rest >= 0:
+            out.append(min(rest, 255))
+            if rest < 255:
+                break
+            rest -= 255
+        out.extend(literals)
+        if offset:
+            out.extend(struct.pack("<H", offset))
+            rest = match_len - MIN_MATCH - 15
+            while rest >= 0:
+                out.append(min(rest, 255))
+                if rest < 255:
+                    break
+                rest -= 255
+
+    while i < limit:
+        seq = int.from_bytes(src[i:i+4], "little")
+        h = _hash(seq)
+        cand = table.get(h)
+        table[h] = i
+        if cand is not None and i - cand <= 0xffff and src[cand:cand+4] == src[i:i+4]:
+            # extender el match
+            m = 4
+            while i + m < limit and src[cand+m] == src[i+m]:
+                m += 1
+            emit(src[anchor:i], m, i - cand)
+            i += m
+            anchor = i
+        else:
+            i += 1
+
+    # cola: solo literales (token sin match)
+    emit(src[anchor:], 0, 0)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Comprime firmware a LZ4 para el boot stub")
+    parser.add_argument("input", help="binario de entrada (demo.bin)")
+    parser.add_argument("output", help="imagen comprimida de salida")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    comp = lz4_compress(data)
+    with open(args.output, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("<III", len(data), len(comp), 0))
+        f.write(comp)
+
+    print(f"[✓] {args.input}: {len(data)} -> {len(comp) + 16} bytes "
+          f"({100*(len(comp)+16)//max(len(data),1)}%)")
+
+
+if __name__ == "__main__":
+    main()
@@ -13,65 +13,21 @@
 #include <inttypes.h>  // Para usar PRIx32
 #include <stdint.h>
 
-typedef void (*bar_func_ptr)(uint32_t);  // Para punteros a funciones CSR
+#include "autorun.h"
+#include "bench.h"
+#include "command.h"
+#include "prof.h"
+#include "sched.h"
+#include "stats.h"
+#include "uartx.h"
 
 /*-----------------------------------------------------------------------*/
 /* UART                                                                  */
 /*-----------------------------------------------------------------------*/
 
-static char *readstr(void)
-{
-	char c[2];
-	static char s[64];
-	static int ptr = 0;
-
-	if(readchar_nonblock()) {
-		c[0] = getchar();
-		c[1] = 0;
-		switch(c[0]) {
-			case 0x7f:
-			case 0x08:
-				if(ptr > 0) {
-					ptr--;
-					fputs("\x08 \x08", stdout);
-				}
-				break;
-			case 0x07:
-				break;
-			case '\r':
-			case '\n':
-				s[ptr] = 0x00;
-				fputs("\n", stdout);
-				ptr = 0;
-				return s;
-			default:
-				if(ptr >= (sizeof(s) - 1))
-					break;
-				fputs(c, stdout);
-				s[ptr] = c[0];
-				ptr++;
-				break;
-		}
-	}
-
-	return NULL;
-}
-
-static char *get_token(char **str)
-{
-	char *c, *d;
-
-	c = (char *)strchr(*str, ' ');
-	if(c == NULL) {
-		d = *str;
-		*str = *str+strlen(*str);
-		return d;
-	}
-	*c = 0;
-	d = *str;
-	*str = c+1;
-	return d;
-}
+/* Line input (echo, backspace, line FIFO) now lives in the UART interrupt
+ * (see uartx.c): pasted command batches are captured even while a command
+ * is running, and console_service() just pops completed lines. */
 
 static void prompt(void)
 {
@@ -79,111 +35,307 @@ static void prompt(void)
 }
 
 /*-----------------------------------------------------------------------*/
-/* Help                                                                  */
+/* Commands                                                              */
 /*-----------------------------------------------------------------------*/
 
-static void help(void)
+/* Each command registers itself in the .cmdtab section (see command.h);
+ * help and dispatch are generated from the table. */
+
+static void help_cmd(char *args)
 {
+	(void)args;
 	puts("\nLiteX minimal demo app by Fabian built "__DATE__" "__TIME__"\n");
 	puts("Available commands:");
-	puts("help               - Show this command");
-	puts("reboot             - Reboot CPU");
-#ifdef CSR_LEDS_BASE
-	puts("led                - Led demo");
-#endif
-	puts("donut              - Spinning Donut demo");
-	puts("helloc             - Hello C");
-#ifdef WITH_CXX
-	puts("hellocpp           - Hello C++");
-#endif
+	cmd_help();
 }
+REGISTER_CMD(help, help_cmd, "Show this command");
 
-/*-----------------------------------------------------------------------*/
-/* Commands                                                              */
-/*-----------------------------------------------------------------------*/
-
-static void reboot_cmd(void)
+static void reboot_cmd(char *args)
 {
+	(void)args;
 	ctrl_reset_write(1);
 }
+REGISTER_CMD(reboot, reboot_cmd, "Reboot CPU");
 
 #ifdef CSR_LEDS_BASE
-static void led_cmd(void)
-{
-	int i;
-	printf("Led demo...\n");
+#include "led.h"
 
-	printf("Counter mode...\n");
-	for(i=0; i<32; i++) {
-		leds_out_write(i);
-		busy_wait(100);
-	}
-
-	printf("Shift mode...\n");
-	for(i=0; i<4; i++) {
-		leds_out_write(1<<i);
-		busy_wait(200);
-	}
-	for(i=0; i<4; i++) {
-		leds_out_write(1<<(3-i));
-		busy_wait(200);
-	}
-
-	printf("Dance mode...\n");
-	for(i=0; i<4; i++) {
-		leds_out_write(0x55);
-		busy_wait(200);
-		leds_out_write(0xaa);
-		busy_wait(200);
+/* Arranca la animacion en segundo plano y vuelve a la consola de
+ * inmediato: el ISR del timer va dando los pasos (ver led.c). */
+static void led_cmd(char *args)
+{
+	char *mode = get_token(&args);
+
+	if(strcmp(mode, "shift") == 0) {
+		printf("Led shift mode (background)...\n");
+		led_anim_shift();
+	} else if(strcmp(mode, "dance") == 0) {
+		printf("Led dance mode (background)...\n");
+		led_anim_dance();
+	} else if(strcmp(mode, "off") == 0) {
+		led_anim_stop();
+	} else {
+		printf("Led counter mode (background)...\n");
+		led_anim_counter(100);
 	}
 }
+REGISTER_CMD(led, led_cmd, "Background led animation (counter/shift/dance/off)");
 #endif
 
 extern void donut(void);
+#ifdef CSR_FB_BASE
+extern void donut_hdmi(void);
+#endif
 
-static void donut_cmd(void)
+static void donut_cmd(char *args)
 {
+	char *mode = get_token(&args);
+
+#ifdef CSR_FB_BASE
+	if(strcmp(mode, "hdmi") == 0) {
+		printf("Donut demo (HDMI framebuffer)...\n");
+		donut_hdmi();
+		return;
+	}
+#else
+	(void)mode;
+#endif
 	printf("Donut demo...\n");
 	donut();
 }
+REGISTER_CMD(donut, donut_cmd, "Spinning Donut demo (UART, or 'donut hdmi')");
 
 
-static void helloc_cmd(void)
+#ifdef CSR_BARS_UPDATE_ADDR
+/* Escribe las 16 posiciones via el CSR empaquetado de BarsC: un acceso de
+ * bus por barra en vez de un CSR dedicado por barra. */
+static void bars_update_all(const uint16_t *starts)
+{
+	for (int i = 0; i < 16; i++)
+		bars_update_write(((uint32_t)i << 16) | starts[i]);
+}
+
+static void helloc_cmd(char *args)
 {
+	(void)args;
+
 	printf("Hello C demo... (press 'q' to stop)\n");
 
-	bar_func_ptr bar_writes[16] = {
-		bars_start_0_write, bars_start_1_write, bars_start_2_write, bars_start_3_write,
-		bars_start_4_write, bars_start_5_write, bars_start_6_write, bars_start_7_write,
-		bars_start_8_write, bars_start_9_write, bars_start_10_write, bars_start_11_write,
-		bars_start_12_write, bars_start_13_write, bars_start_14_write, bars_start_15_write
-	};
+	/* Posiciones base: una escritura empaquetada por barra. */
+	uint16_t starts[16];
+	for (int i = 0; i < 16; i++)
+		starts[i] = i * 40;
+	bars_update_all(starts);
 
+	/* Animacion: el desplazamiento global es un solo acceso CSR por frame;
+	 * el wrap modulo 640 lo hace el hardware. El ritmo lo marca el tick
+	 * del sistema (60 Hz exactos, CPU dormida entre frames). */
 	int offset = 0;
+	uartx_rx_raw(1);
 	while (1) {
-		if (readchar_nonblock()) {
-			char c = readchar();
-			if (c == 'q') break;  // salir si se presiona 'q'
-		}
+		if (uartx_getchar() == 'q')
+			break;  // salir si se presiona 'q'
 
-		for (int i = 0; i < 16; i++) {
-			bar_writes[i]((i * 40 + offset) % 640);
-		}
+		PROF_ENTER(PROF_HELLOC_FRAME, "helloc.frame");
+		bars_offset_write(offset);
 		offset = (offset + 1) % 640;
+		PROF_EXIT(PROF_HELLOC_FRAME);
 
-		for (volatile int j = 0; j < 100000; j++);
+		sched_wait_frame();
 	}
+	uartx_rx_raw(0);
 
 	printf("\nhelloc terminado.\n");
 }
+REGISTER_CMD(helloc, helloc_cmd, "Hello C");
+#endif
+
+#ifdef CSR_DMA_BASE
+#include <generated/mem.h>
+#include "dma.h"
+
+static void dma_cmd(char *args)
+{
+	volatile uint32_t *ram = (volatile uint32_t *)(MAIN_RAM_BASE + 0x100000);
+	int i, errors = 0;
+
+	(void)args;
+
+	printf("DMA demo...\n");
+
+	dma_memset((void *)ram, 0xa5, 4096);
+	for(i = 0; i < 1024; i++)
+		if(ram[i] != 0xa5a5a5a5) errors++;
+
+	dma_memcpy((void *)(ram + 1024), (void *)ram, 4096);
+	for(i = 0; i < 1024; i++)
+		if(ram[1024 + i] != 0xa5a5a5a5) errors++;
+
+	if(errors)
+		printf("dma: %d errors\n", errors);
+	else
+		printf("dma: fill + copy of 4KB OK\n");
+}
+REGISTER_CMD(dma, dma_cmd, "DMA copy/fill demo");
+#endif
+
+static void bench_cmd(char *args)
+{
+	(void)args;
+	bench();
+}
+REGISTER_CMD(bench, bench_cmd, "CPU/memory/CSR benchmark suite");
+
+static void profile_cmd(char *args)
+{
+	(void)args;
+	prof_dump();
+}
+REGISTER_CMD(profile, profile_cmd, "Dump and reset hot-path cycle counters");
+
+static void stats_cmd(char *args)
+{
+	(void)args;
+	stats_dump();
+}
+REGISTER_CMD(stats, stats_cmd, "Hardware perf counters (frames, stalls, ...)");
+
+#if defined(CSR_UART_PHY_TUNING_WORD_ADDR) && defined(CSR_TIMER0_BASE)
+/* Renegotiates the UART bit rate through the PHY tuning-word CSR. The
+ * confirmation handshake keeps boot-time compatibility: if nothing
+ * arrives at the new rate within ~2s, we fall back to the old one. */
+static void baud_cmd(char *args)
+{
+	unsigned int rate = strtoul(get_token(&args), NULL, 0);
+	uint32_t old_tw, new_tw;
+	unsigned int deadline;
+	int confirmed = 0;
+
+	if(rate < 9600 || rate > 3000000) {
+		printf("usage: baud <rate>  (9600..3000000)\n");
+		return;
+	}
+
+	new_tw = (uint32_t)(((uint64_t)rate << 32)/CONFIG_CLOCK_FREQUENCY);
+	old_tw = uart_phy_tuning_word_read();
+
+	printf("Switching to %u baud: reconnect and press any key within 2s to keep it...\n", rate);
+	uartx_flush();
+
+	uart_phy_tuning_word_write(new_tw);
+
+	uartx_rx_raw(1);
+	deadline = sched_ticks() + 120; /* 2s at the 60Hz system tick */
+	while((int)(deadline - sched_ticks()) > 0) {
+		if(uartx_getchar() >= 0) {
+			confirmed = 1;
+			break;
+		}
+	}
+	uartx_rx_raw(0);
+
+	if(confirmed) {
+		printf("Now running at %u baud.\n", rate);
+	} else {
+		uart_phy_tuning_word_write(old_tw);
+		printf("No response at %u baud, reverted.\n", rate);
+	}
+}
+REGISTER_CMD(baud, baud_cmd, "Switch UART rate at runtime (baud <rate>)");
+#endif
+
+#ifdef CSR_SPRITES_BASE
+#include "sprites.h"
+
+/* Animacion software sobre el display list: la CPU solo escribe un CSR
+ * por sprite y por frame, el compositing es todo gateware. */
+static void sprite_cmd(char *args)
+{
+	int x[SPRITES_NSLOTS], y[SPRITES_NSLOTS];
+	int dx[SPRITES_NSLOTS], dy[SPRITES_NSLOTS];
+	int i;
+
+	(void)args;
+
+	printf("Sprite demo... (press 'q' to stop)\n");
+
+	for(i = 0; i < SPRITES_NSLOTS; i++) {
+		x[i]  = 40 + 60*i;
+		y[i]  = 30 + 40*i;
+		dx[i] = (i & 1) ? 1 : -1;
+		dy[i] = (i & 2) ? 1 : -1;
+	}
+
+	uartx_rx_raw(1);
+	while(1) {
+		if(uartx_getchar() == 'q')
+			break;
+		sprites_wait_vblank();
+		for(i = 0; i < SPRITES_NSLOTS; i++) {
+			x[i] += dx[i];
+			y[i] += dy[i];
+			if(x[i] <= 0 || x[i] >= 640-64) dx[i] = -dx[i];
+			if(y[i] <= 0 || y[i] >= 480-64) dy[i] = -dy[i];
+			sprite_set(i, x[i], y[i], 0, 1);
+		}
+	}
+
+	uartx_rx_raw(0);
+
+	for(i = 0; i < SPRITES_NSLOTS; i++)
+		sprite_disable(i);
+	printf("\nsprite demo done.\n");
+}
+REGISTER_CMD(sprite, sprite_cmd, "Multi-sprite display list demo");
+#endif
+
+#ifdef CSR_TILEMAP_BASE
+#include "tilemap.h"
+
+/* Edita la pantalla en RAM y hace blit durante el vblank: la misma
+ * actualizacion que antes pedia resintetizar el bitstream ahora son
+ * unos KB de escrituras CSR. */
+static void tilemap_cmd(char *args)
+{
+	int frame = 0;
+
+	(void)args;
+
+	printf("Tilemap demo... (press 'q' to stop)\n");
+
+	tilemap_fill(0);
+	tilemap_blit();
+
+	uartx_rx_raw(1);
+	while(1) {
+		if(uartx_getchar() == 'q')
+			break;
+		/* Banda diagonal de tiles que avanza un paso por frame. */
+		for(int y = 0; y < TILEMAP_ROWS; y++) {
+			tilemap_set((frame + y) % TILEMAP_COLS, y, 0);
+			tilemap_set((frame + y + 1) % TILEMAP_COLS, y, 1);
+		}
+		tilemap_blit();
+		frame++;
+	}
+	uartx_rx_raw(0);
+
+	tilemap_fill(0);
+	tilemap_blit();
+	printf("\ntilemap demo done.\n");
+}
+REGISTER_CMD(tilemap, tilemap_cmd, "CPU-driven tilemap demo");
+#endif
 
 #ifdef WITH_CXX
 extern void hellocpp(void);
-static void hellocpp_cmd(void)
+static void hellocpp_cmd(char *args)
 {
+	(void)args;
 	printf("Hello C++ demo...\n");
 	hellocpp();
 }
+REGISTER_CMD(hellocpp, hellocpp_cmd, "Hello C++ (constexpr fixed-point demo)");
 #endif
 
 /*-----------------------------------------------------------------------*/
@@ -193,27 +345,10 @@ static void hellocpp_cmd(void)
 static void console_service(void)
 {
 	char *str;
-	char *token;
 
-	str = readstr();
+	str = uartx_readline();
 	if(str == NULL) return;
-	token = get_token(&str);
-	if(strcmp(token, "help") == 0)
-		help();
-	else if(strcmp(token, "reboot") == 0)
-		reboot_cmd();
-#ifdef CSR_LEDS_BASE
-	else if(strcmp(token, "led") == 0)
-		led_cmd();
-#endif
-	else if(strcmp(token, "donut") == 0)
-		donut_cmd();
-	else if(strcmp(token, "helloc") == 0)
-		helloc_cmd();
-#ifdef WITH_CXX
-	else if(strcmp(token, "hellocpp") == 0)
-		hellocpp_cmd();
-#endif
+	cmd_exec(str);
 	prompt();
 }
 
@@ -225,7 +360,15 @@ int main(void)
 #endif
 	uart_init();
 
-	help();
+	/* Tick del sistema a 60 Hz: marca el paso de las animaciones en
+	 * segundo plano (leds) y el ritmo de frame de los demos. */
+	sched_init(60, NULL);
+
+	/* Arranque headless: si hay script en flash lo ejecuta ya (con
+	 * ventana para escapar a la consola); al terminar cae al prompt. */
+	autorun_exec();
+
+	help_cmd(NULL);
 	prompt();
 
 	while(1) {
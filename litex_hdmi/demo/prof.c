@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "prof.h"
+
+prof_site_t prof_sites[PROF_NSITES];
+
+void prof_reset(void)
+{
+	memset(prof_sites, 0, sizeof(prof_sites));
+}
+
+void prof_dump(void)
+{
+	int i;
+
+	printf("%-20s %10s %12s %10s\n", "site", "hits", "cycles", "cyc/hit");
+	for(i = 0; i < PROF_NSITES; i++) {
+		prof_site_t *s = &prof_sites[i];
+		if(!s->hits)
+			continue;
+		printf("%-20s %10lu %12lu %10lu\n",
+		       s->name ? s->name : "?",
+		       (unsigned long)s->hits,
+		       (unsigned long)s->cycles,
+		       (unsigned long)(s->cycles/s->hits));
+	}
+	prof_reset();
+}
@@ -0,0 +1,53 @@
+#ifndef __PROF_H
+#define __PROF_H
+
+#include <stdint.h>
+
+/* Lightweight cycle-count profiling for firmware hot paths. Each site
+ * accumulates total cycles and hit count in a static table; overhead is
+ * two rdcycle reads plus a few stores per ENTER/EXIT pair, cheap enough
+ * to stay enabled in production builds. Dump/reset with the profile
+ * console command. */
+
+enum {
+	PROF_DONUT_CLEAR,   /* memsets of b[]/z[] */
+	PROF_DONUT_INNER,   /* one j-iteration of the projection loop */
+	PROF_DONUT_TX,      /* frame output (UART ring / framebuffer) */
+	PROF_HELLOC_FRAME,  /* one bars animation update */
+	PROF_NSITES
+};
+
+typedef struct {
+	const char *name;
+	uint32_t    hits;
+	uint64_t    cycles;
+	uint32_t    tstart;
+} prof_site_t;
+
+extern prof_site_t prof_sites[PROF_NSITES];
+
+static inline uint32_t prof_rdcycle(void)
+{
+#ifdef __riscv
+	uint32_t cycles;
+	__asm__ volatile("rdcycle %0" : "=r"(cycles));
+	return cycles;
+#else
+	return 0;
+#endif
+}
+
+#define PROF_ENTER(site, n) do { \
+	prof_sites[site].name   = (n); \
+	prof_sites[site].tstart = prof_rdcycle(); \
+} while(0)
+
+#define PROF_EXIT(site) do { \
+	prof_sites[site].cycles += (uint32_t)(prof_rdcycle() - prof_sites[site].tstart); \
+	prof_sites[site].hits++; \
+} while(0)
+
+void prof_dump(void);
+void prof_reset(void);
+
+#endif /* __PROF_H */
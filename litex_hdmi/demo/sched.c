@@ -0,0 +1,74 @@
+#include <stddef.h>
+
+#include <irq.h>
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+#include "led.h"
+#include "sched.h"
+
+#ifdef CSR_TIMER0_BASE
+
+static volatile unsigned int ticks;
+static sched_callback_t callback;
+
+/* Called from isr() on every timer0 event. Keep callbacks short: they run
+ * with the frame period as their deadline. The LED animation engine is
+ * stepped here too, so it keeps running whatever the foreground does. */
+void sched_isr(void)
+{
+	timer0_ev_pending_write(1);
+	ticks++;
+	led_anim_isr();
+	if(callback)
+		callback();
+}
+
+void sched_init(unsigned int hz, sched_callback_t cb)
+{
+	unsigned int period = CONFIG_CLOCK_FREQUENCY/hz;
+
+	timer0_en_write(0);
+	callback = cb;
+	ticks = 0;
+	timer0_load_write(period);
+	timer0_reload_write(period);
+	timer0_en_write(1);
+	timer0_ev_pending_write(timer0_ev_pending_read());
+	timer0_ev_enable_write(1);
+	irq_setmask(irq_getmask() | (1 << TIMER0_INTERRUPT));
+}
+
+void sched_stop(void)
+{
+	timer0_ev_enable_write(0);
+	timer0_en_write(0);
+	callback = NULL;
+}
+
+unsigned int sched_ticks(void)
+{
+	return ticks;
+}
+
+/* Sleep (wfi) until the next timer tick; the CPU is free for interrupts
+ * in the meantime instead of spinning. */
+void sched_wait_frame(void)
+{
+	unsigned int t = ticks;
+	while(ticks == t) {
+#ifdef __riscv
+		__asm__ volatile("wfi");
+#endif
+	}
+}
+
+#else /* !CSR_TIMER0_BASE */
+
+void sched_isr(void) {}
+void sched_init(unsigned int hz, sched_callback_t cb) { (void)hz; (void)cb; }
+void sched_stop(void) {}
+unsigned int sched_ticks(void) { return 0; }
+void sched_wait_frame(void) {}
+
+#endif
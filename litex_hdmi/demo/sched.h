@@ -0,0 +1,16 @@
+#ifndef __SCHED_H
+#define __SCHED_H
+
+/* Frame scheduler built on the LiteX timer0 interrupt. Replaces the
+ * volatile busy-wait pacing: register an optional per-frame callback at a
+ * requested rate, then sleep between ticks with sched_wait_frame(). */
+
+typedef void (*sched_callback_t)(void);
+
+void sched_init(unsigned int hz, sched_callback_t cb);
+void sched_stop(void);
+void sched_isr(void);
+unsigned int sched_ticks(void);
+void sched_wait_frame(void);
+
+#endif /* __SCHED_H */
@@ -0,0 +1,45 @@
+#include <generated/csr.h>
+
+#include "sprites.h"
+
+#ifdef CSR_SPRITES_BASE
+
+/* The slot CSRs are contiguous 32-bit registers, so a slot index maps
+ * straight to an address offset from slot_0. */
+void sprite_set(int slot, int x, int y, int tile, int enable)
+{
+	uint32_t v = ((uint32_t)(enable != 0) << 31) |
+	             (((uint32_t)tile & 0xf)  << 24) |
+	             (((uint32_t)y & 0xfff)   << 12) |
+	             ( (uint32_t)x & 0xfff);
+	csr_write_simple(v, CSR_SPRITES_SLOT_0_ADDR + 4*slot);
+}
+
+void sprite_disable(int slot)
+{
+	csr_write_simple(0, CSR_SPRITES_SLOT_0_ADDR + 4*slot);
+}
+
+/* Wait for the start of the next vblank: sync to a full edge so a burst
+ * of display-list writes lands inside one blanking interval. */
+void sprites_wait_vblank(void)
+{
+	while(sprites_vblank_read());
+	while(!sprites_vblank_read());
+}
+
+#else /* !CSR_SPRITES_BASE */
+
+void sprite_set(int slot, int x, int y, int tile, int enable)
+{
+	(void)slot; (void)x; (void)y; (void)tile; (void)enable;
+}
+
+void sprite_disable(int slot)
+{
+	(void)slot;
+}
+
+void sprites_wait_vblank(void) {}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef __SPRITES_H
+#define __SPRITES_H
+
+#include <stdint.h>
+
+/* Firmware API for the SpriteEngine display list: each slot packs
+ * {enable[31], tile[27:24], y[23:12], x[11:0]} into one CSR write.
+ * Update during vblank (sprites_wait_vblank) to avoid tearing. */
+
+#define SPRITES_NSLOTS 8
+
+void sprite_set(int slot, int x, int y, int tile, int enable);
+void sprite_disable(int slot);
+void sprites_wait_vblank(void);
+
+#endif /* __SPRITES_H */
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdint.h>
+
+#include <generated/csr.h>
+
+#include "prof.h"
+#include "stats.h"
+
+#ifdef CSR_PERF_BASE
+
+/* Each stats call latches-and-clears the hardware counters, so the printed
+ * values cover the interval since the previous call. The cycle counter
+ * over the same interval turns them into rates. */
+static uint32_t last_cycles;
+static int have_last;
+
+void stats_dump(void)
+{
+	uint32_t now, elapsed;
+	uint32_t secs_x100;
+
+	perf_latch_write(1);
+	now = prof_rdcycle();
+	elapsed = now - last_cycles;
+	last_cycles = now;
+
+	if(!have_last) {
+		have_last = 1;
+		printf("stats: counters armed, run a workload and call stats again.\n");
+		return;
+	}
+
+	/* Hundredths of a second, to keep the math in 32 bits. */
+	secs_x100 = elapsed / (CONFIG_CLOCK_FREQUENCY/100);
+	if(secs_x100 == 0)
+		secs_x100 = 1;
+
+	printf("stats over the last %lu.%02lus:\n",
+		(unsigned long)(secs_x100/100), (unsigned long)(secs_x100%100));
+#ifdef CSR_PERF_FRAMES_ADDR
+	{
+		uint32_t v = perf_frames_read();
+		printf("  hdmi frames : %10lu (%lu.%02lu fps)\n",
+			(unsigned long)v, (unsigned long)(v*100/secs_x100),
+			(unsigned long)((v*10000/secs_x100)%100));
+	}
+#endif
+#ifdef CSR_PERF_HRAM_STALL_ADDR
+	{
+		uint32_t v = perf_hram_stall_read();
+		printf("  hram stalls : %10lu cycles (%lu%% of bus clock)\n",
+			(unsigned long)v, (unsigned long)(((uint64_t)v*100)/elapsed));
+	}
+#endif
+#ifdef CSR_PERF_FLASH_READS_ADDR
+	printf("  flash reads : %10lu\n", (unsigned long)perf_flash_reads_read());
+#endif
+#ifdef CSR_PERF_UART_TX_ADDR
+	printf("  uart tx     : %10lu bytes\n", (unsigned long)perf_uart_tx_read());
+#endif
+}
+
+#else /* !CSR_PERF_BASE */
+
+void stats_dump(void)
+{
+	printf("stats: no perf-counter block in this SoC.\n");
+}
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef __STATS_H
+#define __STATS_H
+
+/* Printout of the hardware perf-counter block (stats console command). */
+
+void stats_dump(void);
+
+#endif /* __STATS_H */
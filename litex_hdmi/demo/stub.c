@@ -0,0 +1,80 @@
+// Decompressing boot stub: runs XIP from the rom region in SPI flash,
+// inflates the LZ4-packed firmware appended at _payload into main_ram and
+// jumps there. Keeping the stub tiny means the boot-time flash traffic is
+// the compressed image plus ~1KB of stub instead of the full binary.
+//
+// libc-free on purpose: linked with crt0 + this file only (see stub.ld).
+
+#include <stdint.h>
+
+#include <generated/mem.h>
+
+#define LZ4_MAGIC 0x42345a4c /* "LZ4B" little-endian */
+
+struct lz4_header {
+	uint32_t magic;
+	uint32_t orig_size;
+	uint32_t comp_size;
+	uint32_t reserved;
+};
+
+extern char _payload[];  /* set by stub.ld: stub base + 0x1000 in flash */
+
+int main(void);
+
+/* Minimal LZ4 block decoder (matches lz4_pack.py). */
+static uint32_t lz4_decompress(const uint8_t *src, uint32_t src_len, uint8_t *dst)
+{
+	const uint8_t *end = src + src_len;
+	uint8_t *d = dst;
+
+	while(src < end) {
+		uint8_t token = *src++;
+		uint32_t len = token >> 4;
+
+		if(len == 15) {
+			uint8_t x;
+			do { x = *src++; len += x; } while(x == 255);
+		}
+		while(len--)
+			*d++ = *src++;
+		if(src >= end)
+			break;  /* final sequence: literals only */
+
+		uint32_t offset = src[0] | (src[1] << 8);
+		src += 2;
+		len = (token & 15) + 4;
+		if((token & 15) == 15) {
+			uint8_t x;
+			do { x = *src++; len += x; } while(x == 255);
+		}
+		{
+			const uint8_t *m = d - offset;
+			while(len--)
+				*d++ = *m++;  /* byte copy: offsets may overlap */
+		}
+	}
+	return d - dst;
+}
+
+int main(void)
+{
+	const struct lz4_header *hdr = (const struct lz4_header *)_payload;
+	void (*app)(void) = (void (*)(void))MAIN_RAM_BASE;
+
+	if(hdr->magic == LZ4_MAGIC) {
+		lz4_decompress((const uint8_t *)(hdr + 1), hdr->comp_size,
+		               (uint8_t *)MAIN_RAM_BASE);
+#ifdef __riscv
+		__asm__ volatile("fence.i");
+#endif
+		app();
+	}
+	/* bad/missing payload: spin so the fault is visible on a debugger */
+	for(;;);
+	return 0;
+}
+
+/* crt0 needs an isr symbol; the stub runs with interrupts off. */
+void isr(void);
+void isr(void) {}
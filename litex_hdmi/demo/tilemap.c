@@ -0,0 +1,69 @@
+#include <generated/csr.h>
+
+#include "fastcode.h"
+#include "tilemap.h"
+
+#ifdef CSR_TILEMAP_BASE
+
+/* Shadow copy of the on-screen map plus a per-row dirty flag. The 1.2KB
+ * shadow lives in main_ram so it does not eat into the 8KB sram; rows is
+ * small enough to stay in .bss. Only dirty rows are flushed, so a partial
+ * update costs a few dozen CSR writes and a full-screen redraw (1200
+ * cells, 2 CSR writes each) still fits inside one blanking interval. */
+static uint8_t shadow[TILEMAP_COLS * TILEMAP_ROWS] __attribute__((section(".mainram_bss")));
+static uint8_t row_dirty[TILEMAP_ROWS];
+
+void tilemap_set(int x, int y, uint8_t tile)
+{
+	if(x < 0 || x >= TILEMAP_COLS || y < 0 || y >= TILEMAP_ROWS)
+		return;
+	shadow[y * TILEMAP_COLS + x] = tile;
+	row_dirty[y] = 1;
+}
+
+void tilemap_fill(uint8_t tile)
+{
+	int i;
+	for(i = 0; i < TILEMAP_COLS * TILEMAP_ROWS; i++)
+		shadow[i] = tile;
+	for(i = 0; i < TILEMAP_ROWS; i++)
+		row_dirty[i] = 1;
+}
+
+static void tilemap_wait_vblank(void)
+{
+	while(tilemap_vblank_read());
+	while(!tilemap_vblank_read());
+}
+
+void FASTCODE tilemap_blit(void)
+{
+	int x, y;
+
+	tilemap_wait_vblank();
+	for(y = 0; y < TILEMAP_ROWS; y++) {
+		if(!row_dirty[y])
+			continue;
+		row_dirty[y] = 0;
+		for(x = 0; x < TILEMAP_COLS; x++) {
+			tilemap_wr_addr_write(y * TILEMAP_COLS + x);
+			tilemap_wr_data_write(shadow[y * TILEMAP_COLS + x]);
+		}
+	}
+}
+
+#else /* !CSR_TILEMAP_BASE */
+
+void tilemap_set(int x, int y, uint8_t tile)
+{
+	(void)x; (void)y; (void)tile;
+}
+
+void tilemap_fill(uint8_t tile)
+{
+	(void)tile;
+}
+
+void tilemap_blit(void) {}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __TILEMAP_H
+#define __TILEMAP_H
+
+#include <stdint.h>
+
+/* Firmware API for the CPU-writable tilemap: tilemap_set() only touches a
+ * shadow copy in RAM, tilemap_blit() flushes the dirty rows through the
+ * CSR write window during the next vertical blanking interval. */
+
+#define TILEMAP_COLS 40 /* 640 / 16 */
+#define TILEMAP_ROWS 30 /* 480 / 16 */
+
+void tilemap_set(int x, int y, uint8_t tile);
+void tilemap_fill(uint8_t tile);
+void tilemap_blit(void);
+
+#endif /* __TILEMAP_H */
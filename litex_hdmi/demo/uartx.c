@@ -0,0 +1,210 @@
+#include <string.h>
+
+#include <irq.h>
+#include <libbase/uart.h>
+#include <generated/csr.h>
+
+#include "uartx.h"
+
+#if defined(CONFIG_CPU_HAS_INTERRUPT) && !defined(UART_POLLING)
+
+/* Big enough for a full donut frame (1761 bytes) plus the cursor escape,
+ * so frame N+1 renders while frame N drains over the wire. */
+#define UARTX_RINGBUFFER_SIZE_TX 2048
+#define UARTX_RINGBUFFER_MASK_TX (UARTX_RINGBUFFER_SIZE_TX-1)
+
+/* In main_ram: with the donut frame buffers now doubled, 2KB of ring no
+ * longer fits in sram, and the ISR only reads one byte per TX event. */
+static char tx_buf[UARTX_RINGBUFFER_SIZE_TX] __attribute__((section(".mainram_bss")));
+static volatile unsigned int tx_produce;
+static volatile unsigned int tx_consume;
+
+/* Called from isr() on every UART event (after uart_isr): push queued
+ * bytes into the FIFO until it fills up again. */
+void uartx_isr_tx(void)
+{
+	while((tx_consume != tx_produce) && !uart_txfull_read()) {
+		uart_rxtx_write(tx_buf[tx_consume & UARTX_RINGBUFFER_MASK_TX]);
+		uart_ev_pending_write(UART_EV_TX);
+		tx_consume++;
+	}
+}
+
+/* Prime the FIFO with interrupts masked; needed to (re)start transmission
+ * when the ring was empty and no TX event is coming. */
+static void uartx_kick(void)
+{
+	unsigned int oldmask;
+
+	oldmask = irq_getmask();
+	irq_setmask(oldmask & ~(1 << UART_INTERRUPT));
+	uartx_isr_tx();
+	irq_setmask(oldmask);
+}
+
+void uartx_putc(char c)
+{
+	while((tx_produce - tx_consume) == UARTX_RINGBUFFER_SIZE_TX)
+		uartx_kick();  /* full: help drain while we wait */
+	tx_buf[tx_produce & UARTX_RINGBUFFER_MASK_TX] = c;
+	tx_produce++;
+	uartx_kick();
+}
+
+void uartx_flush(void)
+{
+	while(tx_consume != tx_produce)
+		uartx_kick();
+	uart_sync();
+}
+
+#else /* polling fallback: degrade to the blocking libbase path */
+
+void uartx_isr_tx(void) {}
+
+void uartx_putc(char c)
+{
+	uart_write(c);
+}
+
+void uartx_flush(void)
+{
+	uart_sync();
+}
+
+#endif
+
+void uartx_write(const char *s, int len)
+{
+	int i;
+	for(i = 0; i < len; i++)
+		uartx_putc(s[i]);
+}
+
+void uartx_puts(const char *s)
+{
+	uartx_write(s, strlen(s));
+}
+
+/*-----------------------------------------------------------------------*/
+/* RX line FIFO                                                          */
+/*-----------------------------------------------------------------------*/
+
+#define UARTX_NLINES   4
+#define UARTX_LINE_LEN 64
+
+static char rx_lines[UARTX_NLINES][UARTX_LINE_LEN];
+static volatile unsigned int rx_line_produce;
+static volatile unsigned int rx_line_consume;
+static unsigned int rx_pos;
+
+static volatile int rx_raw_mode;
+static char rx_raw_buf[16];
+static volatile unsigned int rx_raw_produce;
+static volatile unsigned int rx_raw_consume;
+
+/* Drains whatever the UART has pending into the line FIFO (or the raw
+ * ring in raw mode), applying the echo/backspace line discipline. In
+ * interrupt mode this runs from the UART ISR; in the polling fallback
+ * the readers below call it themselves. */
+static void uartx_rx_process(void)
+{
+	char c;
+
+	while(uart_read_nonblock()) {
+		c = uart_read();
+
+		if(rx_raw_mode) {
+			if((rx_raw_produce - rx_raw_consume) < sizeof(rx_raw_buf)) {
+				rx_raw_buf[rx_raw_produce % sizeof(rx_raw_buf)] = c;
+				rx_raw_produce++;
+			}
+			continue;
+		}
+
+		switch(c) {
+		case 0x7f:
+		case 0x08:
+			if(rx_pos > 0) {
+				rx_pos--;
+				uartx_puts("\x08 \x08");
+			}
+			break;
+		case 0x07:
+			break;
+		case '\r':
+		case '\n':
+			/* FIFO full: the in-progress slot is still the oldest
+			 * unread line, so hold the line until it drains. */
+			if((rx_line_produce - rx_line_consume) == UARTX_NLINES)
+				break;
+			rx_lines[rx_line_produce % UARTX_NLINES][rx_pos] = 0;
+			uartx_putc('\n');
+			rx_line_produce++;
+			rx_pos = 0;
+			break;
+		default:
+			if((rx_line_produce - rx_line_consume) == UARTX_NLINES)
+				break;
+			if(rx_pos < UARTX_LINE_LEN - 1) {
+				rx_lines[rx_line_produce % UARTX_NLINES][rx_pos] = c;
+				rx_pos++;
+				uartx_putc(c);
+			}
+			break;
+		}
+	}
+}
+
+void uartx_isr_rx(void)
+{
+#if defined(CONFIG_CPU_HAS_INTERRUPT) && !defined(UART_POLLING)
+	uartx_rx_process();
+#endif
+}
+
+int uartx_line_ready(void)
+{
+#if !defined(CONFIG_CPU_HAS_INTERRUPT) || defined(UART_POLLING)
+	uartx_rx_process();
+#endif
+	return rx_line_produce != rx_line_consume;
+}
+
+/* Returns the oldest completed line (NUL-terminated, without the
+ * newline), or NULL if none is pending. The returned buffer is valid
+ * until the next call. */
+char *uartx_readline(void)
+{
+	static char out[UARTX_LINE_LEN];
+
+	if(!uartx_line_ready())
+		return NULL;
+	/* The slot is complete before produce is bumped, and the ISR never
+	 * writes into unconsumed slots, so no masking is needed here. */
+	memcpy(out, rx_lines[rx_line_consume % UARTX_NLINES], UARTX_LINE_LEN);
+	rx_line_consume++;
+	return out;
+}
+
+void uartx_rx_raw(int enable)
+{
+	rx_raw_mode = enable;
+	if(!enable)
+		rx_raw_consume = rx_raw_produce; /* discard stale keys */
+}
+
+/* Raw-mode key poll: -1 if no key is pending. */
+int uartx_getchar(void)
+{
+	int c;
+
+#if !defined(CONFIG_CPU_HAS_INTERRUPT) || defined(UART_POLLING)
+	uartx_rx_process();
+#endif
+	if(rx_raw_consume == rx_raw_produce)
+		return -1;
+	c = (unsigned char)rx_raw_buf[rx_raw_consume % sizeof(rx_raw_buf)];
+	rx_raw_consume++;
+	return c;
+}
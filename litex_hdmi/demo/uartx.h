@@ -0,0 +1,25 @@
+#ifndef __UARTX_H
+#define __UARTX_H
+
+/* Bulk TX path for the UART: a large ring buffer drained from the UART
+ * interrupt, so renderers can queue a whole frame and keep computing while
+ * it transmits. Writers only stall when the ring is genuinely full. */
+
+void uartx_putc(char c);
+void uartx_write(const char *s, int len);
+void uartx_puts(const char *s);
+void uartx_flush(void);
+void uartx_isr_tx(void);
+
+/* RX path: the UART interrupt assembles complete lines (echo, backspace)
+ * into a small FIFO, so pasted command batches survive long-running
+ * commands instead of overflowing the 128-byte libbase ring. Demos that
+ * want raw keys ('q' to quit) switch to raw mode while they run. */
+
+int uartx_line_ready(void);
+char *uartx_readline(void);
+void uartx_rx_raw(int enable);
+int uartx_getchar(void);
+void uartx_isr_rx(void);
+
+#endif /* __UARTX_H */
@@ -1,9 +1,9 @@
 from migen import *
 from migen.genlib.cdc import MultiReg
 from litex.gen import LiteXModule, log2_int
-from litex.soc.interconnect import stream
+from litex.soc.interconnect import stream, wishbone
 from litex.soc.cores.video import video_timing_layout, video_data_layout
-from litex.soc.interconnect.csr import CSRStorage, AutoCSR
+from litex.soc.interconnect.csr import CSR, CSRStorage, CSRStatus, AutoCSR
 import random
 from math import log2
 from math import isqrt
@@ -58,11 +58,493 @@ class WishboneReader(LiteXModule):
         ]
 
 
-class TilemapRenderer(LiteXModule):
+class WishboneBurstReader(LiteXModule):
+    """
+    Lector Wishbone a rafagas con FIFO de prefetch, pensado como etapa de
+    fetch para los motores de scanout: a diferencia de WishboneReader (una
+    direccion, un handshake, una palabra), este emite lecturas de direccion
+    incremental en rafagas de burst_length palabras (cti/bte de Wishbone
+    registered-feedback) hacia un FIFO de stream.
+
+    Con clock_domain distinto de "sys" el FIFO es asincrono y source queda
+    en ese dominio (p.ej. "hdmi"); el lado de bus corre siempre en sys. El
+    watermark (solo caso sincrono: AsyncFIFO no expone level) decide cuando
+    lanzar la siguiente rafaga para que el FIFO no se vacie; con FIFO
+    asincrono la rafaga se lanza en cuanto hay hueco (sink.ready).
+    """
+    def __init__(self, burst_length=8, fifo_depth=32, watermark=None,
+                 clock_domain="sys"):
+        self.bus   = bus = wishbone.Interface(bursting=True)
+        self.base  = Signal(32)   # direccion byte inicial
+        self.count = Signal(24)   # palabras a leer
+        self.start = Signal()
+        self.busy  = Signal()
+
+        layout = [("data", 32)]
+        if clock_domain == "sys":
+            if watermark is None:
+                watermark = fifo_depth - burst_length
+            assert watermark <= fifo_depth - burst_length
+            fifo = stream.SyncFIFO(layout, fifo_depth, buffered=True)
+            can_burst = Signal()
+        else:
+            assert watermark is None, "watermark requiere clock_domain='sys'"
+            fifo = ClockDomainsRenamer({"write": "sys", "read": clock_domain})(
+                stream.AsyncFIFO(layout, fifo_depth, buffered=True))
+            can_burst = None
+        self.fifo   = fifo
+        self.source = fifo.source
+
+        adr        = Signal(30)
+        remaining  = Signal(24)
+        beat       = Signal(max=max(burst_length + 1, 2))
+
+        if can_burst is not None:
+            self.comb += can_burst.eq(fifo.level <= watermark)
+        else:
+            can_burst = fifo.sink.ready
+
+        self.comb += [
+            fifo.sink.data.eq(bus.dat_r),
+            fifo.sink.valid.eq(bus.ack & bus.cyc & ~bus.we),
+        ]
+
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        fsm.act("IDLE",
+            If(self.start,
+                NextValue(adr, self.base >> 2),
+                NextValue(remaining, self.count),
+                NextState("WAIT")
+            )
+        )
+        fsm.act("WAIT",
+            self.busy.eq(1),
+            If(remaining == 0,
+                NextState("IDLE")
+            ).Elif(can_burst & fifo.sink.ready,
+                NextValue(beat, Mux(remaining >= burst_length,
+                                    burst_length, remaining)),
+                NextState("BURST")
+            )
+        )
+        fsm.act("BURST",
+            self.busy.eq(1),
+            bus.cyc.eq(1),
+            bus.stb.eq(fifo.sink.ready),
+            bus.sel.eq(0xf),
+            bus.we.eq(0),
+            bus.adr.eq(adr),
+            bus.cti.eq(Mux(beat == 1, 0b111, 0b010)),  # incrementing/end
+            bus.bte.eq(0b00),
+            If(bus.ack,
+                NextValue(adr, adr + 1),
+                NextValue(remaining, remaining - 1),
+                NextValue(beat, beat - 1),
+                If(beat == 1,
+                    NextState("WAIT")
+                )
+            )
+        )
+
+
+class WishboneDMA(LiteXModule, AutoCSR):
+    """
+    Motor DMA simple de copia/relleno sobre Wishbone.
+
+    La CPU programa src/dst/length (bytes, alineados a palabra) y dispara
+    start; en modo fill se escribe fill_value en vez de leer de src. done
+    se limpia al arrancar y vuelve a 1 al terminar, asi el firmware puede
+    lanzar la transferencia y seguir calculando el siguiente frame.
+    """
+    MODE_COPY = 0
+    MODE_FILL = 1
+
+    def __init__(self):
+        self.bus = wishbone.Interface()
+
+        self.src        = CSRStorage(32, description="Direccion origen (modo copy).")
+        self.dst        = CSRStorage(32, description="Direccion destino.")
+        self.length     = CSRStorage(32, description="Longitud en bytes (multiplo de 4).")
+        self.fill_value = CSRStorage(32, description="Palabra a escribir en modo fill.")
+        self.mode       = CSRStorage(1,  description="0: copy, 1: fill.")
+        self.start      = CSR()
+        self.done       = CSRStatus(reset=1)
+
+        # # #
+
+        src_adr   = Signal(30)
+        dst_adr   = Signal(30)
+        remaining = Signal(30)  # palabras pendientes
+        data_reg  = Signal(32)
+
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        fsm.act("IDLE",
+            self.done.status.eq(1),
+            If(self.start.re & (self.length.storage[2:] != 0),
+                NextValue(src_adr,   self.src.storage[2:]),
+                NextValue(dst_adr,   self.dst.storage[2:]),
+                NextValue(remaining, self.length.storage[2:]),
+                If(self.mode.storage == self.MODE_FILL,
+                    NextValue(data_reg, self.fill_value.storage),
+                    NextState("WRITE")
+                ).Else(
+                    NextState("READ")
+                )
+            )
+        )
+        fsm.act("READ",
+            self.bus.stb.eq(1),
+            self.bus.cyc.eq(1),
+            self.bus.sel.eq(0xf),
+            self.bus.we.eq(0),
+            self.bus.adr.eq(src_adr),
+            If(self.bus.ack,
+                NextValue(data_reg, self.bus.dat_r),
+                NextValue(src_adr, src_adr + 1),
+                NextState("WRITE")
+            )
+        )
+        fsm.act("WRITE",
+            self.bus.stb.eq(1),
+            self.bus.cyc.eq(1),
+            self.bus.sel.eq(0xf),
+            self.bus.we.eq(1),
+            self.bus.adr.eq(dst_adr),
+            self.bus.dat_w.eq(data_reg),
+            If(self.bus.ack,
+                NextValue(dst_adr, dst_adr + 1),
+                NextValue(remaining, remaining - 1),
+                If(remaining == 1,
+                    NextState("IDLE")
+                ).Elif(self.mode.storage == self.MODE_FILL,
+                    NextState("WRITE")
+                ).Else(
+                    NextState("READ")
+                )
+            )
+        )
+
+
+class HyperRAMLineCache(LiteXModule):
+    """
+    Cache de lineas delante del esclavo HyperRAM: el core vendido
+    (hyperbus.py) paga la latencia completa comando+direccion en cada
+    acceso de 32 bits, asi que unas pocas lineas de 32 bytes con prefetch
+    secuencial hacen que las relecturas y los barridos lineales sirvan
+    desde BRAM y solo los fallos frios paguen la latencia. Escrituras:
+    write-through con invalidacion de la linea afectada.
+    """
+    def __init__(self, master, slave, nlines=4, linewords=8, prefetch=True):
+        # master: bus que ve el SoC; slave: bus hacia el core HyperRAM.
+        word_bits = log2_int(linewords)
+        tag_bits  = len(master.adr) - word_bits
+
+        valids = Array(Signal()         for _ in range(nlines))
+        tags   = Array(Signal(tag_bits) for _ in range(nlines))
+        data   = Array(Array(Signal(32) for _ in range(linewords))
+                       for _ in range(nlines))
+
+        req_tag  = Signal(tag_bits)
+        req_word = Signal(word_bits)
+        self.comb += [
+            req_tag.eq(master.adr[word_bits:]),
+            req_word.eq(master.adr[:word_bits]),
+        ]
+
+        # Deteccion de hit (comparadores en paralelo, prioridad fija).
+        hits     = Signal(nlines)
+        hit      = Signal()
+        hit_line = Signal(max=nlines)
+        self.comb += [hits[i].eq(valids[i] & (tags[i] == req_tag))
+                      for i in range(nlines)]
+        self.comb += hit.eq(hits != 0)
+        for i in reversed(range(nlines)):
+            self.comb += If(hits[i], hit_line.eq(i))
+
+        # Linea de reemplazo: round-robin.
+        replace  = Signal(max=nlines)
+        beat     = Signal(word_bits)
+        fill_tag = Signal(tag_bits)
+
+        serve_read = [
+            master.ack.eq(1),
+            master.dat_r.eq(data[hit_line][req_word]),
+        ]
+
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        fsm.act("IDLE",
+            If(master.cyc & master.stb,
+                If(master.we,
+                    # Write-through: pasa al core y invalida la linea.
+                    slave.cyc.eq(1),
+                    slave.stb.eq(1),
+                    slave.we.eq(1),
+                    slave.adr.eq(master.adr),
+                    slave.dat_w.eq(master.dat_w),
+                    slave.sel.eq(master.sel),
+                    master.ack.eq(slave.ack),
+                    If(slave.ack & hit,
+                        NextValue(valids[hit_line], 0)
+                    )
+                ).Elif(hit,
+                    *serve_read
+                ).Else(
+                    NextValue(fill_tag, req_tag),
+                    NextValue(beat, 0),
+                    NextState("REFILL")
+                )
+            )
+        )
+        fsm.act("REFILL",
+            slave.cyc.eq(1),
+            slave.stb.eq(1),
+            slave.adr.eq(Cat(beat, fill_tag)),
+            slave.sel.eq(0xf),
+            If(slave.ack,
+                NextValue(data[replace][beat], slave.dat_r),
+                NextValue(beat, beat + 1),
+                If(beat == (linewords - 1),
+                    NextValue(tags[replace],   fill_tag),
+                    NextValue(valids[replace], 1),
+                    NextValue(replace, replace + 1),
+                    # La peticion pendiente se sirve como hit al volver.
+                    NextValue(fill_tag, fill_tag + 1),
+                    NextValue(beat, 0),
+                    NextState("PREFETCH" if prefetch else "IDLE")
+                )
+            )
+        )
+        if prefetch:
+            # Evita duplicar una linea ya cacheada (un duplicado dejaria
+            # una copia rancia tras la invalidacion por escritura).
+            pf_dup = Signal()
+            self.comb += pf_dup.eq(
+                Cat(*[valids[i] & (tags[i] == fill_tag)
+                      for i in range(nlines)]) != 0)
+            fsm.act("PREFETCH",
+                # Trae la linea siguiente mientras la CPU consume la
+                # actual; los hits se siguen sirviendo y cualquier otra
+                # peticion aborta el prefetch (la linea parcial se tira).
+                If(master.cyc & master.stb & ~master.we & hit,
+                    *serve_read
+                ),
+                If(master.cyc & master.stb & (master.we | ~hit),
+                    NextState("IDLE")
+                ).Elif(pf_dup & (beat == 0),
+                    NextState("IDLE")
+                ).Else(
+                    # La victima deja de ser valida antes de pisarle la
+                    # primera palabra: aqui (a diferencia de REFILL) se
+                    # siguen sirviendo hits, y un hit sobre la linea a
+                    # medio rellenar mezclaria palabras viejas y nuevas.
+                    If(beat == 0,
+                        NextValue(valids[replace], 0)
+                    ),
+                    slave.cyc.eq(1),
+                    slave.stb.eq(1),
+                    slave.adr.eq(Cat(beat, fill_tag)),
+                    slave.sel.eq(0xf),
+                    If(slave.ack,
+                        NextValue(data[replace][beat], slave.dat_r),
+                        NextValue(beat, beat + 1),
+                        If(beat == (linewords - 1),
+                            NextValue(tags[replace],   fill_tag),
+                            NextValue(valids[replace], 1),
+                            NextValue(replace, replace + 1),
+                            NextState("IDLE")
+                        )
+                    )
+                )
+            )
+
+
+class PerfCounters(LiteXModule, AutoCSR):
+    """
+    Contadores de eventos de 32 bits para observabilidad: el SoC registra
+    senales (frames, ciclos de stall del bus, etc.) con add_event() y el
+    firmware las lee por CSR (comando "stats"). Escribir en latch copia y
+    pone a cero todos los contadores de forma atomica.
+    """
+    def __init__(self):
+        self.latch = CSR()
+
+    def add_event(self, name, signal, edge=False, cdc=False, description=""):
+        status = CSRStatus(32, name=name, description=description)
+        setattr(self, name, status)
+
+        sig = signal
+        if cdc:
+            # Senal de otro dominio de reloj: sincroniza antes de contar.
+            sig = Signal()
+            self.specials += MultiReg(signal, sig)
+        if edge:
+            prev = Signal()
+            inc  = Signal()
+            self.sync += prev.eq(sig)
+            self.comb += inc.eq(sig & ~prev)
+        else:
+            inc = sig
+
+        count = Signal(32)
+        self.sync += [
+            If(self.latch.re,
+                status.status.eq(count),
+                count.eq(0)
+            ).Elif(inc,
+                count.eq(count + 1)
+            )
+        ]
+
+
+class CharFramebuffer(LiteXModule, AutoCSR):
+    """
+    Escanea un buffer de caracteres (80x22, 1 byte por celda) desde main_ram
+    (HyperRAM) y lo convierte en video: cada celda se dibuja como un bloque de
+    8x16 pixeles con un nivel de gris tomado de una LUT de luminancia ASCII.
+
+    La CPU solo escribe los 1760 bytes del frame en HyperRAM; el scanout corre
+    completo en gateware, asi que la UART queda fuera del camino caliente.
+    Pensado para el demo "donut hdmi" (la paleta ".,-~:;=!*#$@" mapea a grises).
+    """
+    CHARS_X = 80
+    CHARS_Y = 22
+    CELL_W  = 8
+    CELL_H  = 16
+
+    def __init__(self, base_addr=0x40200000):
+        self.vtg_sink = stream.Endpoint(video_timing_layout)
+        self.source   = stream.Endpoint(video_data_layout)
+
+        self.base = CSRStorage(32, reset=base_addr,
+            description="Direccion base del buffer de caracteres en main_ram.")
+
+        chars_x = self.CHARS_X
+        chars_y = self.CHARS_Y
+
+        # LUT de luminancia: ' ' -> 0 y la rampa ".,-~:;=!*#$@" -> 12 niveles.
+        lum_init = [0]*128
+        ramp = ".,-~:;=!*#$@"
+        for n, ch in enumerate(ramp):
+            lum_init[ord(ch)] = (n + 1) * 255 // len(ramp)
+        lum_rom  = Memory(width=8, depth=128, init=lum_init)
+        lum_port = lum_rom.get_port(clock_domain="hdmi")
+        self.specials += lum_rom, lum_port
+
+        # Line buffer de una fila de caracteres: escrito en sys, leido en hdmi.
+        line_buf = Memory(width=8, depth=chars_x)
+        wr_port  = line_buf.get_port(write_capable=True, clock_domain="sys")
+        rd_port  = line_buf.get_port(clock_domain="hdmi")
+        self.specials += line_buf, wr_port, rd_port
+
+        # Lado hdmi: coordenadas de celda.
+        h = self.vtg_sink.hcount
+        v = self.vtg_sink.vcount
+        char_col = Signal(max=chars_x)
+        char_row = Signal(8)
+        active   = Signal()
+        self.comb += [
+            char_col.eq(h[3:10]),           # /CELL_W
+            char_row.eq(v[4:]),             # /CELL_H
+            active.eq(char_row < chars_y),
+            rd_port.adr.eq(char_col),
+            lum_port.adr.eq(rd_port.dat_r[:7]),
+        ]
+
+        # Lado sys: al cambiar de fila, la rafaga de 20 palabras la emite
+        # WishboneBurstReader y esta FSM solo vacia su FIFO de prefetch al
+        # line buffer (una palabra se desempaqueta mientras llega la
+        # siguiente, en vez de un handshake completo por palabra).
+        char_row_sys = Signal(8)
+        self.specials += MultiReg(char_row, char_row_sys)
+
+        self.burst = burst = WishboneBurstReader(burst_length=chars_x//4,
+                                                 fifo_depth=32)
+        self.bus = burst.bus
+        self.comb += [
+            burst.base.eq(self.base.storage + char_row_sys*chars_x),
+            burst.count.eq(chars_x//4),
+        ]
+
+        row_loaded = Signal(8, reset=0xff)
+        word_idx   = Signal(max=chars_x//4)  # 20 palabras de 32 bits por fila
+        word_reg   = Signal(32)
+        byte_idx   = Signal(2)
+
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        fsm.act("IDLE",
+            If((char_row_sys != row_loaded) & (char_row_sys < chars_y),
+                burst.start.eq(1),
+                NextValue(word_idx, 0),
+                NextState("FILL")
+            )
+        )
+        fsm.act("FILL",
+            burst.source.ready.eq(1),
+            If(burst.source.valid,
+                NextValue(word_reg, burst.source.data),
+                NextValue(byte_idx, 0),
+                NextState("STORE")
+            )
+        )
+        fsm.act("STORE",
+            wr_port.we.eq(1),
+            wr_port.adr.eq(Cat(byte_idx, word_idx)),
+            wr_port.dat_w.eq(word_reg[:8]),  # CPU little-endian: byte 0 en LSB
+            NextValue(word_reg, word_reg >> 8),
+            NextValue(byte_idx, byte_idx + 1),
+            If(byte_idx == 3,
+                If(word_idx == (chars_x//4) - 1,
+                    NextValue(row_loaded, char_row_sys),
+                    NextState("IDLE")
+                ).Else(
+                    NextValue(word_idx, word_idx + 1),
+                    NextState("FILL")
+                )
+            )
+        )
+
+        # Salida de video: gris dentro del area activa, negro fuera.
+        gray = Signal(8)
+        self.comb += [
+            gray.eq(Mux(active, lum_port.dat_r, 0)),
+            self.vtg_sink.connect(self.source,
+                keep={"valid","ready","last","de","hsync","vsync"}),
+            self.source.r.eq(gray),
+            self.source.g.eq(gray),
+            self.source.b.eq(gray),
+        ]
+
+
+class PaletteRAM(LiteXModule, AutoCSR):
+    """
+    Paleta CSR-escribible para la etapa de salida de los renderers: los
+    tiles se guardan como indices de 4/8 bits y esta RAM de 256x24 los
+    convierte a RGB. Un tercio de la BRAM que las tres ROMs de 8 bits por
+    canal, y la CPU puede recolorear en caliente via wr_addr/wr_data.
+    """
+    def __init__(self, palette_data, read_domain="sys"):
+        size = 256
+        init = list(palette_data) + [0]*(size - len(palette_data))
+        self.mem     = Memory(width=24, depth=size, init=init[:size])
+        self.rd_port = self.mem.get_port(clock_domain=read_domain)
+        wr_port      = self.mem.get_port(write_capable=True, clock_domain="sys")
+        self.specials += self.mem, self.rd_port, wr_port
+
+        self.wr_addr = CSRStorage(8,  description="Indice de paleta a escribir.")
+        self.wr_data = CSRStorage(24, description="Color RGB; la escritura dispara la actualizacion.")
+        self.comb += [
+            wr_port.adr.eq(self.wr_addr.storage),
+            wr_port.dat_w.eq(self.wr_data.storage),
+            wr_port.we.eq(self.wr_data.re),
+        ]
+
+
+class TilemapRenderer(LiteXModule, AutoCSR):
     def __init__(self, tile_rom_data,
                  screen_w=640, screen_h=480,
                  tile_w=16, tile_h=16,
-                 tilemap_data=None):
+                 tilemap_data=None,
+                 palette_data=None):
 
         # Endpoints
         self.vtg_sink = stream.Endpoint(video_timing_layout)
@@ -86,23 +568,63 @@ class TilemapRenderer(LiteXModule):
         max_index = num_tiles - 1 if num_tiles > 1 else 1
         idx_bits = max_index.bit_length()
 
-        # Tilemap ROM
-        self.tilemap_rom  = Memory(width=idx_bits, depth=num_cells, init=tilemap_data)
-        self.tilemap_port = self.tilemap_rom.get_port(clock_domain="hdmi", has_re=True)
-        self.specials += self.tilemap_rom, self.tilemap_port
+        # Tilemap RAM: puerto de lectura en hdmi para el scanout y puerto de
+        # escritura en sys para la CPU. El init sigue sirviendo de contenido
+        # por defecto, pero el firmware puede reescribir celdas via CSR sin
+        # resintetizar el bitstream.
+        self.tilemap_ram  = Memory(width=idx_bits, depth=num_cells, init=tilemap_data)
+        self.tilemap_port = self.tilemap_ram.get_port(clock_domain="hdmi", has_re=True)
+        self.wr_port      = self.tilemap_ram.get_port(write_capable=True, clock_domain="sys")
+        self.specials += self.tilemap_ram, self.tilemap_port, self.wr_port
+
+        # Ventana CSR de escritura (mismo esquema que PaletteRAM): escribir
+        # wr_data dispara la escritura en wr_addr. vblank permite al firmware
+        # agrupar un blit completo dentro del blanking vertical.
+        self.wr_addr = CSRStorage(bits_for(num_cells - 1), description="Celda destino (y*tiles_x + x).")
+        self.wr_data = CSRStorage(idx_bits, description="Indice de tile; escribir aqui efectua la escritura.")
+        self.vblank  = CSRStatus(description="1 durante el blanking vertical.")
+        self.comb += [
+            self.wr_port.adr.eq(self.wr_addr.storage),
+            self.wr_port.dat_w.eq(self.wr_data.storage),
+            self.wr_port.we.eq(self.wr_data.re),
+            self.vblank.status.eq(self.vtg_sink.vsync),
+        ]
 
-        # Tile ROM split RGB
+        # Tile ROM: RGB directo (3x8 bits) o indices de paleta (1x8 bits)
         depth = total_pixels
-        init_r = [(v >> 16) & 0xFF for v in tile_rom_data]
-        init_g = [(v >>  8) & 0xFF for v in tile_rom_data]
-        init_b = [ v        & 0xFF for v in tile_rom_data]
-        rom_r = Memory(width=8, depth=depth, init=init_r)
-        rom_g = Memory(width=8, depth=depth, init=init_g)
-        rom_b = Memory(width=8, depth=depth, init=init_b)
-        port_r = rom_r.get_port(clock_domain="hdmi")
-        port_g = rom_g.get_port(clock_domain="hdmi")
-        port_b = rom_b.get_port(clock_domain="hdmi")
-        self.specials += rom_r, rom_g, rom_b, port_r, port_g, port_b
+        color_r = Signal(8)
+        color_g = Signal(8)
+        color_b = Signal(8)
+        if palette_data is None:
+            init_r = [(v >> 16) & 0xFF for v in tile_rom_data]
+            init_g = [(v >>  8) & 0xFF for v in tile_rom_data]
+            init_b = [ v        & 0xFF for v in tile_rom_data]
+            rom_r = Memory(width=8, depth=depth, init=init_r)
+            rom_g = Memory(width=8, depth=depth, init=init_g)
+            rom_b = Memory(width=8, depth=depth, init=init_b)
+            port_r = rom_r.get_port(clock_domain="hdmi")
+            port_g = rom_g.get_port(clock_domain="hdmi")
+            port_b = rom_b.get_port(clock_domain="hdmi")
+            self.specials += rom_r, rom_g, rom_b, port_r, port_g, port_b
+            tile_ports = [port_r, port_g, port_b]
+            self.comb += [
+                color_r.eq(port_r.dat_r),
+                color_g.eq(port_g.dat_r),
+                color_b.eq(port_b.dat_r),
+            ]
+        else:
+            # tile_rom_data contiene indices; la paleta resuelve el color.
+            rom_i  = Memory(width=8, depth=depth, init=tile_rom_data)
+            port_i = rom_i.get_port(clock_domain="hdmi")
+            self.specials += rom_i, port_i
+            self.palette = PaletteRAM(palette_data, read_domain="hdmi")
+            tile_ports = [port_i]
+            self.comb += [
+                self.palette.rd_port.adr.eq(port_i.dat_r),
+                color_r.eq(self.palette.rd_port.dat_r[16:24]),
+                color_g.eq(self.palette.rd_port.dat_r[8:16]),
+                color_b.eq(self.palette.rd_port.dat_r[0:8]),
+            ]
 
         # Signals
         tile_x       = Signal(max=tiles_x)
@@ -130,18 +652,18 @@ class TilemapRenderer(LiteXModule):
             tile_addr.eq(tile_id * pixels_per_tile + pixel_y * tile_w + pixel_x),
 
             self.tilemap_port.adr.eq(tilemap_addr),
-            port_r.adr.eq(tile_addr), port_g.adr.eq(tile_addr), port_b.adr.eq(tile_addr),
 
             self.vtg_sink.connect(self.source, keep={"valid","ready","last","de","hsync","vsync"}),
-            self.source.r.eq(port_r.dat_r),
-            self.source.g.eq(port_g.dat_r),
-            self.source.b.eq(port_b.dat_r),
+            self.source.r.eq(color_r),
+            self.source.g.eq(color_g),
+            self.source.b.eq(color_b),
         ]
+        self.comb += [p.adr.eq(tile_addr) for p in tile_ports]
 
         # Register tile_id with 1-cycle delay
         self.sync.hdmi += [ tile_id_next.eq(self.tilemap_port.dat_r), tile_id.eq(tile_id_next) ]
 
-class BarsRenderer(LiteXModule):
+class BarsRenderer(LiteXModule, AutoCSR):
     """
     Dibuja N franjas verticales (una por cada tile de 16×16) en pantalla,
     usando todo el tileset de tu ROM.
@@ -149,7 +671,8 @@ class BarsRenderer(LiteXModule):
     """
     def __init__(self, tile_rom_data,
                  screen_w=640, screen_h=480,
-                 tile_w=16,   tile_h=16):
+                 tile_w=16,   tile_h=16,
+                 palette_data=None):
         # Video endpoints
         self.vtg_sink = stream.Endpoint(video_timing_layout)
         self.source   = stream.Endpoint(video_data_layout)
@@ -161,18 +684,40 @@ class BarsRenderer(LiteXModule):
         stripes_count   = total_tiles                          # uno por cada tile
         stripe_width    = max(1, screen_w // stripes_count)    # ancho de cada franja
 
-        # Carga ROM RGB completa
+        # Carga ROM: RGB completa o indices + paleta
         depth = total_pixels
-        init_r = [(c >> 16) & 0xFF for c in tile_rom_data]
-        init_g = [(c >>  8) & 0xFF for c in tile_rom_data]
-        init_b = [ c        & 0xFF for c in tile_rom_data]
-        rom_r = Memory(width=8, depth=depth, init=init_r)
-        rom_g = Memory(width=8, depth=depth, init=init_g)
-        rom_b = Memory(width=8, depth=depth, init=init_b)
-        port_r = rom_r.get_port(has_re=False)
-        port_g = rom_g.get_port(has_re=False)
-        port_b = rom_b.get_port(has_re=False)
-        self.specials += rom_r, rom_g, rom_b, port_r, port_g, port_b
+        color_r = Signal(8)
+        color_g = Signal(8)
+        color_b = Signal(8)
+        if palette_data is None:
+            init_r = [(c >> 16) & 0xFF for c in tile_rom_data]
+            init_g = [(c >>  8) & 0xFF for c in tile_rom_data]
+            init_b = [ c        & 0xFF for c in tile_rom_data]
+            rom_r = Memory(width=8, depth=depth, init=init_r)
+            rom_g = Memory(width=8, depth=depth, init=init_g)
+            rom_b = Memory(width=8, depth=depth, init=init_b)
+            port_r = rom_r.get_port(has_re=False)
+            port_g = rom_g.get_port(has_re=False)
+            port_b = rom_b.get_port(has_re=False)
+            self.specials += rom_r, rom_g, rom_b, port_r, port_g, port_b
+            tile_ports = [port_r, port_g, port_b]
+            self.comb += [
+                color_r.eq(port_r.dat_r),
+                color_g.eq(port_g.dat_r),
+                color_b.eq(port_b.dat_r),
+            ]
+        else:
+            rom_i  = Memory(width=8, depth=depth, init=tile_rom_data)
+            port_i = rom_i.get_port(has_re=False)
+            self.specials += rom_i, port_i
+            self.palette = PaletteRAM(palette_data)
+            tile_ports = [port_i]
+            self.comb += [
+                self.palette.rd_port.adr.eq(port_i.dat_r),
+                color_r.eq(self.palette.rd_port.dat_r[16:24]),
+                color_g.eq(self.palette.rd_port.dat_r[8:16]),
+                color_b.eq(self.palette.rd_port.dat_r[0:8]),
+            ]
 
         # Señales de coordenadas
         h = self.vtg_sink.hcount
@@ -180,32 +725,57 @@ class BarsRenderer(LiteXModule):
         mask_w = tile_w - 1
         mask_h = tile_h - 1
 
-        # Índice de franja (0..stripes_count-1) usando Mux encadenado
+        # Calculo de bar_idx segmentado en 3 etapas (antes: Mux encadenado
+        # de stripes_count comparadores + multiplicacion en el mismo cono
+        # combinacional, el camino critico del dominio hdmi):
+        #   E1: comparadores en paralelo, registrados (termometro).
+        #   E2: como los umbrales i*stripe_width son monotonos, el indice
+        #       es el popcount del termometro (arbol de sumas, registrado).
+        #   E3: direccion en ROM, registrada.
+        # Los timing signals se retrasan los mismos 3 ciclos.
+        cmp_bits = Signal(stripes_count - 1)
+        h_d1 = Signal(len(h))
+        v_d1 = Signal(len(v))
+        self.sync += [cmp_bits[i-1].eq(h >= i * stripe_width)
+                      for i in range(1, stripes_count)]
+        self.sync += [h_d1.eq(h), v_d1.eq(v)]
+
         bar_idx = Signal(max=stripes_count)
-        expr = 0
-        # iterar de 1 a stripes_count-1
-        for i in range(1, stripes_count):
-            expr = Mux(h >= i * stripe_width, i, expr)
-        self.comb += bar_idx.eq(expr)
+        h_d2 = Signal(len(h))
+        v_d2 = Signal(len(v))
+        self.sync += [
+            bar_idx.eq(sum(cmp_bits[i] for i in range(stripes_count - 1))),
+            h_d2.eq(h_d1),
+            v_d2.eq(v_d1),
+        ]
 
-        # Dirección en ROM: bloque + offset dentro del bloque
         addr = Signal(max=depth)
-        self.comb += addr.eq(
+        self.sync += addr.eq(
             bar_idx * pixels_per_tile +
-            (v & mask_h) * tile_w +
-            (h & mask_w)
+            (v_d2 & mask_h) * tile_w +
+            (h_d2 & mask_w)
         )
 
+        # Retardo parejo para los timing signals
+        def _delay(sig, cycles=3):
+            d = sig
+            for _ in range(cycles):
+                nd = Signal()
+                self.sync += nd.eq(d)
+                d = nd
+            return d
+
         # Conexión a puertos y salida de video
+        self.comb += [p.adr.eq(addr) for p in tile_ports]
         self.comb += [
-            port_r.adr.eq(addr),
-            port_g.adr.eq(addr),
-            port_b.adr.eq(addr),
             self.vtg_sink.connect(self.source,
-                keep={"valid","ready","last","de","hsync","vsync"}),
-            self.source.r.eq(port_r.dat_r),
-            self.source.g.eq(port_g.dat_r),
-            self.source.b.eq(port_b.dat_r),
+                keep={"valid","ready","last"}),
+            self.source.de.eq(_delay(self.vtg_sink.de)),
+            self.source.hsync.eq(_delay(self.vtg_sink.hsync)),
+            self.source.vsync.eq(_delay(self.vtg_sink.vsync)),
+            self.source.r.eq(color_r),
+            self.source.g.eq(color_g),
+            self.source.b.eq(color_b),
         ]
 
 
@@ -322,15 +892,130 @@ class MovingSpritePatternFromFile(LiteXModule):
             )
         )
 
+class SpriteEngine(LiteXModule, AutoCSR):
+    """
+    Motor de sprites con display list por CSR: n_slots sprites de 64x64
+    tomados de una hoja (frames consecutivos de 64x64 en sprite_data), cada
+    slot controlado por un CSR empaquetado que el firmware actualiza en
+    vsync:
+
+        slot_i = {enable[31], tile[27:24], y[23:12], x[11:0]}
+
+    El evaluador trabaja por scanline: al inicio de cada linea se registra
+    que slots la intersectan (line_hit) y por pixel solo se comparan esos.
+    El slot de indice mas bajo queda encima; el color 0x000000 es
+    transparente (fondo negro), igual que en logo.mem.
+    """
+    SPRITE_W = 64
+    SPRITE_H = 64
+
+    def __init__(self, sprite_data, hres=640, vres=480, n_slots=8):
+        self.vtg_sink = stream.Endpoint(video_timing_layout)
+        self.source   = stream.Endpoint(video_data_layout)
+
+        # Display list
+        for i in range(n_slots):
+            setattr(self, f"slot_{i}", CSRStorage(32, name=f"slot_{i}",
+                description="{enable[31], tile[27:24], y[23:12], x[11:0]}"))
+        self.vblank = CSRStatus(description="1 durante vsync: ventana segura "
+            "para actualizar el display list.")
+
+        # Hoja de sprites
+        sprite_mem  = Memory(24, len(sprite_data), init=sprite_data)
+        sprite_port = sprite_mem.get_port(has_re=False)
+        self.specials += sprite_mem, sprite_port
+
+        h = self.vtg_sink.hcount
+        v = self.vtg_sink.vcount
+
+        self.comb += self.vblank.status.eq(self.vtg_sink.vsync)
+
+        # Por slot: campos desempaquetados y test de interseccion de linea,
+        # registrado al inicio de cada scanline.
+        xs, ys, tiles, ens = [], [], [], []
+        line_hit = Signal(n_slots)
+        for i in range(n_slots):
+            st = getattr(self, f"slot_{i}").storage
+            xs.append(st[0:12])
+            ys.append(st[12:24])
+            tiles.append(st[24:28])
+            ens.append(st[31])
+            self.sync += If(h == 0,
+                line_hit[i].eq(ens[i] &
+                               (v >= ys[i]) &
+                               (v < ys[i] + self.SPRITE_H))
+            )
+
+        # Composicion por pixel: gana el slot de indice mas bajo que cubra
+        # el pixel en esta linea (iteracion inversa del Mux encadenado).
+        hit      = Signal()
+        hit_x    = Signal(12)
+        hit_y    = Signal(12)
+        hit_tile = Signal(4)
+        hit_e, x_e, y_e, t_e = 0, 0, 0, 0
+        for i in reversed(range(n_slots)):
+            pix_hit = line_hit[i] & (h >= xs[i]) & (h < xs[i] + self.SPRITE_W)
+            hit_e = Mux(pix_hit, 1, hit_e)
+            x_e   = Mux(pix_hit, xs[i], x_e)
+            y_e   = Mux(pix_hit, ys[i], y_e)
+            t_e   = Mux(pix_hit, tiles[i], t_e)
+        self.comb += [
+            hit.eq(hit_e),
+            hit_x.eq(x_e),
+            hit_y.eq(y_e),
+            hit_tile.eq(t_e),
+        ]
+
+        sprite_addr = Signal(max=max(len(sprite_data), 2))
+        self.comb += [
+            sprite_addr.eq((hit_tile * (self.SPRITE_W * self.SPRITE_H)) +
+                           ((v - hit_y) * self.SPRITE_W) +
+                           (h - hit_x)),
+            sprite_port.adr.eq(sprite_addr),
+        ]
+
+        # FSM de salida (mismo esquema que MovingSpritePatternFromFile)
+        fsm = FSM(reset_state="IDLE")
+        self.fsm = fsm
+
+        fsm.act("IDLE",
+            self.vtg_sink.ready.eq(1),
+            If(self.vtg_sink.valid & self.vtg_sink.first &
+               (self.vtg_sink.hcount == 0) & (self.vtg_sink.vcount == 0),
+                NextState("RUN")
+            )
+        )
+
+        fsm.act("RUN",
+            self.vtg_sink.connect(self.source, keep={"valid", "ready", "last", "de", "hsync", "vsync"}),
+            If(hit,
+                self.source.r.eq(sprite_port.dat_r[16:24]),
+                self.source.g.eq(sprite_port.dat_r[8:16]),
+                self.source.b.eq(sprite_port.dat_r[0:8])
+            ).Else(
+                self.source.r.eq(0),
+                self.source.g.eq(0),
+                self.source.b.eq(0)
+            )
+        )
+
+
 class BarsC(LiteXModule, AutoCSR):
     """
     Dibuja N franjas verticales (una por cada tile de 16×16) en pantalla,
     usando todo el tileset de tu ROM. La posición de cada barra se controla
     desde la CPU vía CSRs start_0…start_N-1.
+
+    Ademas de los CSRs individuales hay una interfaz empaquetada: el CSR
+    update ({index[23:16], value[15:0]}) actualiza una barra por acceso de
+    bus, y el CSR offset desplaza todas las barras (modulo screen_w) con una
+    sola escritura, que es lo que usa la animacion de helloc. Asi un frame
+    completo cuesta 1 acceso en vez de N.
     """
     def __init__(self, tile_rom_data,
                  screen_w=640, screen_h=480,
-                 tile_w=16,   tile_h=16):
+                 tile_w=16,   tile_h=16,
+                 palette_data=None):
         # Endpoints de video
         self.vtg_sink = stream.Endpoint(video_timing_layout)
         self.source   = stream.Endpoint(video_data_layout)
@@ -349,18 +1034,64 @@ class BarsC(LiteXModule, AutoCSR):
                              reset=i * (screen_w // stripes_count),
                              name=f"start_{i}")
             setattr(self, f"start_{i}", csr)
-        # Memorias RGB de todo el tileset
+
+        # Interfaz empaquetada: register file interno + update/offset
+        self.update = CSRStorage(32, description="{index[23:16], value[15:0]}: "
+            "actualiza la posicion de una barra en un solo acceso.")
+        self.offset = CSRStorage(16, description="Desplazamiento global "
+            "(modulo screen_w) aplicado a todas las barras.")
+
+        starts = Array(Signal(16, reset=i * (screen_w // stripes_count))
+                       for i in range(stripes_count))
+        for i in range(stripes_count):
+            csr = getattr(self, f"start_{i}")
+            self.sync += If(csr.re, starts[i].eq(csr.storage))
+        self.sync += If(self.update.re,
+            starts[self.update.storage[16:24]].eq(self.update.storage[:16]))
+
+        # Posiciones efectivas registradas: base + offset con wrap a screen_w.
+        # Se calculan fuera del cono combinacional del comparador de barras.
+        starts_eff = [Signal(16) for _ in range(stripes_count)]
+        for i in range(stripes_count):
+            tmp = Signal(17)
+            self.comb += tmp.eq(starts[i] + self.offset.storage)
+            self.sync += starts_eff[i].eq(
+                Mux(tmp >= screen_w, tmp - screen_w, tmp))
+
+        # Memorias del tileset: RGB completo o indices + paleta
         depth = total_pixels
-        init_r = [(c >> 16) & 0xFF for c in tile_rom_data]
-        init_g = [(c >>  8) & 0xFF for c in tile_rom_data]
-        init_b = [ c        & 0xFF for c in tile_rom_data]
-        rom_r = Memory(width=8, depth=depth, init=init_r)
-        rom_g = Memory(width=8, depth=depth, init=init_g)
-        rom_b = Memory(width=8, depth=depth, init=init_b)
-        port_r = rom_r.get_port(has_re=False)
-        port_g = rom_g.get_port(has_re=False)
-        port_b = rom_b.get_port(has_re=False)
-        self.specials += rom_r, rom_g, rom_b, port_r, port_g, port_b
+        color_r = Signal(8)
+        color_g = Signal(8)
+        color_b = Signal(8)
+        if palette_data is None:
+            init_r = [(c >> 16) & 0xFF for c in tile_rom_data]
+            init_g = [(c >>  8) & 0xFF for c in tile_rom_data]
+            init_b = [ c        & 0xFF for c in tile_rom_data]
+            rom_r = Memory(width=8, depth=depth, init=init_r)
+            rom_g = Memory(width=8, depth=depth, init=init_g)
+            rom_b = Memory(width=8, depth=depth, init=init_b)
+            port_r = rom_r.get_port(has_re=False)
+            port_g = rom_g.get_port(has_re=False)
+            port_b = rom_b.get_port(has_re=False)
+            self.specials += rom_r, rom_g, rom_b, port_r, port_g, port_b
+            tile_ports = [port_r, port_g, port_b]
+            self.comb += [
+                color_r.eq(port_r.dat_r),
+                color_g.eq(port_g.dat_r),
+                color_b.eq(port_b.dat_r),
+            ]
+        else:
+            rom_i  = Memory(width=8, depth=depth, init=tile_rom_data)
+            port_i = rom_i.get_port(has_re=False)
+            self.specials += rom_i, port_i
+            self.palette = PaletteRAM(palette_data)
+            tile_ports = [port_i]
+            self.comb += [
+                self.palette.rd_port.adr.eq(port_i.dat_r),
+                color_r.eq(self.palette.rd_port.dat_r[16:24]),
+                color_g.eq(self.palette.rd_port.dat_r[8:16]),
+                color_b.eq(self.palette.rd_port.dat_r[0:8]),
+            ]
 
         # Señales de coordenadas
         h = self.vtg_sink.hcount
@@ -368,30 +1099,57 @@ class BarsC(LiteXModule, AutoCSR):
         mask_w = tile_w - 1
         mask_h = tile_h - 1
 
-        # Mux encadenado: busca el último i tal que h >= start_x[i]
+        # Calculo de bar_idx segmentado en 3 etapas (como en BarsRenderer,
+        # pero con posiciones arbitrarias de la CPU el indice no es un
+        # popcount: se mantiene el Mux encadenado, solo que ahora sobre
+        # bits ya registrados, sin comparadores en el cono):
+        #   E1: comparadores h >= start_eff[i] en paralelo, registrados.
+        #   E2: Mux encadenado sobre cmp_bits, registrado.
+        #   E3: direccion en ROM, registrada.
+        cmp_bits = Signal(stripes_count)
+        h_d1 = Signal(len(h))
+        v_d1 = Signal(len(v))
+        self.sync += [cmp_bits[i].eq(h >= starts_eff[i])
+                      for i in range(stripes_count)]
+        self.sync += [h_d1.eq(h), v_d1.eq(v)]
+
         bar_idx = Signal(max=stripes_count)
+        h_d2 = Signal(len(h))
+        v_d2 = Signal(len(v))
         expr = 0
         for i in range(stripes_count):
-            start_sig = getattr(self, f"start_{i}").storage
-            expr = Mux(h >= start_sig, i, expr)
-        self.comb += bar_idx.eq(expr)
+            expr = Mux(cmp_bits[i], i, expr)
+        self.sync += [
+            bar_idx.eq(expr),
+            h_d2.eq(h_d1),
+            v_d2.eq(v_d1),
+        ]
 
-        # Dirección en ROM: bloque + offset dentro del bloque
         addr = Signal(max=depth)
-        self.comb += addr.eq(
+        self.sync += addr.eq(
             bar_idx * pixels_per_tile +
-            (v & mask_h) * tile_w +
-            (h & mask_w)
+            (v_d2 & mask_h) * tile_w +
+            (h_d2 & mask_w)
         )
 
+        # Retardo parejo para los timing signals
+        def _delay(sig, cycles=3):
+            d = sig
+            for _ in range(cycles):
+                nd = Signal()
+                self.sync += nd.eq(d)
+                d = nd
+            return d
+
         # Conexión a video
+        self.comb += [p.adr.eq(addr) for p in tile_ports]
         self.comb += [
-            port_r.adr.eq(addr),
-            port_g.adr.eq(addr),
-            port_b.adr.eq(addr),
             self.vtg_sink.connect(self.source,
-                keep={"valid","ready","last","de","hsync","vsync"}),
-            self.source.r.eq(port_r.dat_r),
-            self.source.g.eq(port_g.dat_r),
-            self.source.b.eq(port_b.dat_r),
+                keep={"valid","ready","last"}),
+            self.source.de.eq(_delay(self.vtg_sink.de)),
+            self.source.hsync.eq(_delay(self.vtg_sink.hsync)),
+            self.source.vsync.eq(_delay(self.vtg_sink.vsync)),
+            self.source.r.eq(color_r),
+            self.source.g.eq(color_g),
+            self.source.b.eq(color_b),
         ]
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+#
+# Simulacion Verilator del SoC con los renderers HDMI: permite probar un
+# cambio en patterns.py o en el firmware en segundos en vez del ciclo
+# completo sintesis Gowin + flasheo (~15 min). El video no sale a ningun
+# sitio: el sink siempre acepta, y el bloque PerfCounters cuenta frames,
+# pixeles y bytes UART, asi que el comando "stats" del firmware da FPS y
+# actividad por modulo tambien en simulacion.
+#
+# Uso tipico:
+#   ./sim.py --hdmi-pattern bars --ram-init demo/demo.bin
+#   (en la consola simulada)  litex> stats / bench / helloc
+
+import argparse
+import os
+import random
+
+from migen import *
+
+from litex.build.generic_platform import Pins, Subsignal
+from litex.build.io import CRG
+from litex.build.sim import SimPlatform
+from litex.build.sim.config import SimConfig
+
+from litex.soc.integration.soc import SoCRegion
+from litex.soc.integration.soc_core import SoCCore
+from litex.soc.integration.builder import Builder
+from litex.soc.integration.common import get_mem_data
+
+from litex.soc.cores.video import VideoTimingGenerator
+from litex.soc.interconnect import stream
+
+from patterns import PerfCounters, WishboneDMA
+
+# IOs ----------------------------------------------------------------------
+
+_io = [
+    ("sys_clk", 0, Pins(1)),
+    ("sys_rst", 0, Pins(1)),
+    ("serial", 0,
+        Subsignal("source_valid", Pins(1)),
+        Subsignal("source_ready", Pins(1)),
+        Subsignal("source_data",  Pins(8)),
+        Subsignal("sink_valid",   Pins(1)),
+        Subsignal("sink_ready",   Pins(1)),
+        Subsignal("sink_data",    Pins(8)),
+    ),
+]
+
+class Platform(SimPlatform):
+    def __init__(self):
+        SimPlatform.__init__(self, "SIM", _io)
+
+# Datos sinteticos ---------------------------------------------------------
+
+# Si no hay tiles.mem/logo.mem junto a sim.py, genera contenido aleatorio:
+# para medir FPS y stalls da igual que los pixeles sean ruido.
+def load_mem_or_random(path, n_random):
+    if os.path.exists(path):
+        with open(path) as f:
+            return [int(l.strip(), 16) for l in f if l.strip()]
+    return [random.randrange(1 << 24) for _ in range(n_random)]
+
+# SimSoC -------------------------------------------------------------------
+
+class SimSoC(SoCCore):
+    def __init__(self, hdmi_pattern="bars", ram_init=[], sys_clk_freq=int(27e6), **kwargs):
+        platform = Platform()
+
+        SoCCore.__init__(self, platform, sys_clk_freq,
+            ident = "LiteX sim for Tang Nano 9K HDMI renderers",
+            **kwargs)
+
+        self.comb += platform.trace.eq(1)
+        self.crg = CRG(platform.request("sys_clk"))
+
+        # main_ram integrada en el lugar de la HyperRAM, precargable con
+        # demo.bin (--ram-init) para ejecutar el firmware real.
+        self.add_ram("main_ram",
+            origin = self.mem_map["main_ram"],
+            size   = 4 * 1024 * 1024,
+            contents = ram_init)
+
+        # Sin rom ni BIOS: el CPU resetea directo en main_ram, donde
+        # --ram-init precarga demo.bin (enlazado para ejecutar desde ahi,
+        # ver demo/linker.ld).
+        self.cpu.set_reset_address(self.mem_map["main_ram"])
+
+        # Dominio hdmi = alias de sys: los renderers instancian sus puertos
+        # en "hdmi" y asi corren sin PLL ni reloj de pixel real.
+        self.clock_domains.cd_hdmi = ClockDomain()
+        self.comb += [
+            self.cd_hdmi.clk.eq(ClockSignal("sys")),
+            self.cd_hdmi.rst.eq(ResetSignal("sys")),
+        ]
+
+        # DMA (igual que en el target real, para donut hdmi / dma_memcpy).
+        self.dma = WishboneDMA()
+        self.bus.add_master(name="dma", master=self.dma.bus)
+
+        # Renderer bajo prueba + sumidero que siempre acepta.
+        self.submodules.vtg = VideoTimingGenerator(default_video_timings="640x480@60Hz")
+
+        # Mismos nombres de instancia que el target real para que los CSRs
+        # (bars_update, tilemap_wr_addr, sprites_slot_0...) que usa el
+        # firmware existan tambien en simulacion.
+        if hdmi_pattern == "bars":
+            from patterns import BarsRenderer
+            tile_data = load_mem_or_random("tiles.mem", 16*16*16)
+            self.submodules.bars = BarsRenderer(tile_data)
+            self.renderer = self.bars
+        elif hdmi_pattern == "c":
+            from patterns import BarsC
+            tile_data = load_mem_or_random("tiles.mem", 16*16*16)
+            self.submodules.bars = BarsC(tile_data)
+            self.renderer = self.bars
+        elif hdmi_pattern == "fb":
+            from patterns import CharFramebuffer
+            self.submodules.fb = CharFramebuffer(
+                base_addr=self.mem_map["main_ram"] + 0x200000)
+            self.bus.add_master(name="fb_dma", master=self.fb.bus)
+            self.renderer = self.fb
+        elif hdmi_pattern == "tilemap":
+            from patterns import TilemapRenderer
+            tile_data = load_mem_or_random("tiles.mem", 16*16*16)
+            self.submodules.tilemap = TilemapRenderer(tile_data)
+            self.renderer = self.tilemap
+        elif hdmi_pattern == "sprites":
+            from patterns import SpriteEngine
+            sprite_data = load_mem_or_random("logo.mem", 64*64)
+            self.submodules.sprites = SpriteEngine(sprite_data)
+            self.renderer = self.sprites
+        else:
+            raise ValueError("Unsupported HDMI pattern: {}".format(hdmi_pattern))
+
+        self.comb += [
+            self.vtg.source.connect(self.renderer.vtg_sink),
+            self.renderer.source.ready.eq(1),
+        ]
+
+        # Contadores: el comando stats del firmware lee FPS/actividad de
+        # aqui, igual que en hardware.
+        self.perf = PerfCounters()
+        self.perf.add_event("frames", self.vtg.source.vsync, edge=True,
+            description="Frames emitidos (flancos de vsync).")
+        self.perf.add_event("pixels",
+            self.renderer.source.valid & self.renderer.source.ready,
+            description="Pixeles aceptados por el sink.")
+        if hasattr(self, "uart_phy"):
+            self.perf.add_event("uart_tx",
+                self.uart_phy.sink.valid & self.uart_phy.sink.ready,
+                description="Bytes entregados al PHY UART.")
+
+# Build --------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description="LiteX sim for the HDMI pattern renderers.")
+    parser.add_argument("--hdmi-pattern", default="bars", choices=["bars", "c", "fb", "tilemap", "sprites"], help="Renderer under test.")
+    parser.add_argument("--ram-init", default=None, help="demo.bin to preload in main_ram.")
+    parser.add_argument("--no-run", action="store_true", help="Only elaborate/build, do not run Verilator.")
+    args = parser.parse_args()
+
+    sys_clk_freq = int(27e6)
+
+    ram_init = []
+    if args.ram_init is not None:
+        ram_init = get_mem_data(args.ram_init, endianness="little")
+
+    soc = SimSoC(
+        hdmi_pattern = args.hdmi_pattern,
+        ram_init     = ram_init,
+        sys_clk_freq = sys_clk_freq,
+        uart_name    = "sim",
+    )
+
+    sim_config = SimConfig()
+    sim_config.add_clocker("sys_clk", freq_hz=sys_clk_freq)
+    sim_config.add_module("serial2console", "serial")
+
+    builder = Builder(soc, output_dir="build/sim", csr_csv="build/sim/csr.csv")
+    builder.build(sim_config=sim_config, run=not args.no_run)
+
+if __name__ == "__main__":
+    main()
@@ -16,8 +16,19 @@ from litex.soc.cores.hyperbus import HyperRAM
 from litex.soc.cores.gpio import GPIOTristate
 from litex.soc.interconnect import wishbone
 from patterns import BarsRenderer
+
+# Modos de video soportados: nombre VTG -> (ancho, alto, pixel clock).
+# El PLL de video genera 5x el pixel clock para el serializador HDMI;
+# 720p pide 371.25 MHz en hdmi5x, el limite practico del GW1NR-9.
+video_modes = {
+    "640x480@60Hz":  (640,  480,  25e6),
+    "640x480@75Hz":  (640,  480,  31.5e6),
+    "800x600@60Hz":  (800,  600,  40e6),
+    "1280x720@60Hz": (1280, 720,  74.25e6),
+}
+
 class _CRG(LiteXModule):
-    def __init__(self, platform, sys_clk_freq, with_video_pll=True):
+    def __init__(self, platform, sys_clk_freq, with_video_pll=True, pixel_clk=25e6):
         self.rst    = Signal()
         self.cd_sys = ClockDomain()
 
@@ -35,7 +46,7 @@ class _CRG(LiteXModule):
             video_pll.register_clkin(clk27, 27e6)
             self.cd_hdmi   = ClockDomain()
             self.cd_hdmi5x = ClockDomain()
-            video_pll.create_clkout(self.cd_hdmi5x, 125e6)
+            video_pll.create_clkout(self.cd_hdmi5x, 5*pixel_clk)
             self.specials += Instance("CLKDIV",
                 p_DIV_MODE="5",
                 i_RESETN=rst_n,
@@ -48,17 +59,50 @@ class BaseSoC(SoCCore):
         with_led_chaser=True,
         with_video_terminal=False,
         hdmi_pattern="bars",
+        video_mode="640x480@60Hz",
+        flash_clk_freq=27e6,
+        flash_cache_size=512,
+        hyperram_cache_lines=4,
         **kwargs):
 
+        assert video_mode in video_modes
+        hres, vres, pixel_clk = video_modes[video_mode]
+
         platform = sipeed_tang_nano_9k.Platform(toolchain=toolchain)
-        self.crg = _CRG(platform, sys_clk_freq, with_video_pll=with_video_terminal)
+        self.crg = _CRG(platform, sys_clk_freq, with_video_pll=with_video_terminal,
+                        pixel_clk=pixel_clk)
 
         kwargs["integrated_rom_size"] = 0
         SoCCore.__init__(self, platform, sys_clk_freq, ident="LiteX SoC on Tang Nano 9K HDMI", **kwargs)
 
+        # SPI Flash (XIP). El Tang Nano 9K solo rutea CLK/CS/MOSI/MISO del
+        # W25Q32, asi que no hay modo quad posible; en su lugar subimos el
+        # reloj SPI y ponemos una cache directa delante de la ventana XIP
+        # para que los bucles calientes no paguen la latencia serie por
+        # cada fetch (medible con el comando bench).
+        from litespi import LiteSPI
+        from litespi.phy.generic import LiteSPIPHY
         from litespi.modules import W25Q32
         from litespi.opcodes import SpiNorFlashOpCodes as Codes
-        self.add_spi_flash(mode="1x", module=W25Q32(Codes.READ_1_1_1), with_master=False)
+        flash_module = W25Q32(Codes.READ_1_1_1)
+        self.spiflash_phy  = LiteSPIPHY(platform.request("spiflash"), flash_module,
+            device=platform.device,
+            default_divisor=int(sys_clk_freq/flash_clk_freq),
+            rate="1:1")
+        self.spiflash_core = LiteSPI(phy=self.spiflash_phy,
+            mmap_endianness=self.cpu.endianness, with_master=False)
+        spiflash_region = SoCRegion(
+            origin=self.mem_map.get("spiflash", 0x00000000),
+            size=flash_module.total_size)
+        if flash_cache_size:
+            xip_bus = wishbone.Interface()
+            self.submodules.spiflash_cache = wishbone.Cache(
+                cachesize=flash_cache_size//4,
+                master=xip_bus,
+                slave=self.spiflash_core.bus)
+            self.bus.add_slave(name="spiflash", slave=xip_bus, region=spiflash_region)
+        else:
+            self.bus.add_slave(name="spiflash", slave=self.spiflash_core.bus, region=spiflash_region)
 
         self.bus.add_region("rom", SoCRegion(
             origin=self.bus.regions["spiflash"].origin + bios_flash_offset,
@@ -91,27 +135,52 @@ class BaseSoC(SoCCore):
                 os.system("mv hyperbus.py.txt hyperbus.py")
             from hyperbus import HyperRAM
             self.hyperram = HyperRAM(hyperram_pads)
-            self.bus.add_slave("main_ram", slave=self.hyperram.bus, region=SoCRegion(
+            # Cache de lineas con prefetch delante del core: el core paga la
+            # latencia completa por cada acceso de 32 bits, asi las relecturas
+            # y los barridos secuenciales (memcpy, scanout) sirven desde BRAM.
+            if hyperram_cache_lines:
+                from patterns import HyperRAMLineCache
+                main_ram_bus = wishbone.Interface()
+                self.submodules.hyperram_cache = HyperRAMLineCache(
+                    master = main_ram_bus,
+                    slave  = self.hyperram.bus,
+                    nlines = hyperram_cache_lines)
+            else:
+                main_ram_bus = self.hyperram.bus
+            self.bus.add_slave("main_ram", slave=main_ram_bus, region=SoCRegion(
                 origin=self.mem_map["main_ram"], size=4 * MEGABYTE, mode="rwx"))
 
-            
+            # DMA de copia/relleno: clears y blits a velocidad de bus mientras
+            # la CPU calcula el siguiente frame (ver dma_memcpy/dma_memset).
+            from patterns import WishboneDMA
+            self.dma = WishboneDMA()
+            self.bus.add_master(name="dma", master=self.dma.bus)
+
+
             if with_video_terminal:
                 if hdmi_pattern == "c":
                     from patterns import BarsC
                     # 1) Instancia el VTG y el PHY HDMI
-                    self.submodules.vtg     = VideoTimingGenerator(default_video_timings="640x480@60Hz")
+                    self.submodules.vtg     = VideoTimingGenerator(default_video_timings=video_mode)
                     self.submodules.videophy= VideoGowinHDMIPHY(platform.request("hdmi"),
                                                                 clock_domain="hdmi")
 
-                    # 2) Después, carga tu tiles.mem y crea el renderer
+                    # 2) Después, carga tu tiles.mem y crea el renderer.
+                    #    Si existe palette.mem, tiles.mem contiene indices
+                    #    (salida de tileset_to_mem.py --palette): 1/3 de BRAM.
                     with open("tiles.mem") as f:
                         tile_rgb_data = [int(l.strip(), 16) for l in f if l.strip()]
+                    palette_data = None
+                    if os.path.exists("palette.mem"):
+                        with open("palette.mem") as f:
+                            palette_data = [int(l.strip(), 16) for l in f if l.strip()]
 
                     self.submodules.bars = ClockDomainsRenamer("hdmi")(
                         BarsC(
                             tile_rgb_data,
-                            screen_w=640, screen_h=480,
-                            tile_w=16,   tile_h=16
+                            screen_w=hres, screen_h=vres,
+                            tile_w=16,   tile_h=16,
+                            palette_data=palette_data
                         )
                     )
 
@@ -129,7 +198,7 @@ class BaseSoC(SoCCore):
                     from patterns import BarsRenderer
 
                     # 1) Instancia el VTG y el PHY HDMI
-                    self.submodules.vtg = VideoTimingGenerator(default_video_timings="640x480@60Hz")
+                    self.submodules.vtg = VideoTimingGenerator(default_video_timings=video_mode)
                     self.submodules.videophy = VideoGowinHDMIPHY(
                         platform.request("hdmi"),
                         clock_domain="hdmi"
@@ -146,7 +215,7 @@ class BaseSoC(SoCCore):
                         tile_rom_data += [color] * (16 * 16)  # 256 píxeles por tile
 
                     self.submodules.bars = ClockDomainsRenamer("hdmi")(
-                        BarsRenderer(tile_rom_data, screen_w=640, screen_h=480, tile_w=16, tile_h=16)
+                        BarsRenderer(tile_rom_data, screen_w=hres, screen_h=vres, tile_w=16, tile_h=16)
                     )
 
                     # 3) Conecta toda la cadena
@@ -159,34 +228,81 @@ class BaseSoC(SoCCore):
                 elif hdmi_pattern == "sprite":
                     from patterns import MovingSpritePatternFromFile
                     self.videophy = VideoGowinHDMIPHY(platform.request("hdmi"), clock_domain="hdmi")
-                    self.submodules.vtg = VideoTimingGenerator(default_video_timings="640x480@75Hz")
+                    self.submodules.vtg = VideoTimingGenerator(default_video_timings=video_mode)
 
                     self.submodules.sprite_pattern = MovingSpritePatternFromFile(
-                        hres=640,
-                        vres=480
+                        hres=hres,
+                        vres=vres
                     )
 
                     self.comb += [
                         self.vtg.source.connect(self.sprite_pattern.vtg_sink),
                         self.sprite_pattern.source.connect(self.videophy.sink)
                     ]
+                elif hdmi_pattern == "sprites":
+                    from patterns import SpriteEngine
+                    self.videophy = VideoGowinHDMIPHY(platform.request("hdmi"), clock_domain="hdmi")
+                    self.submodules.vtg = VideoTimingGenerator(default_video_timings=video_mode)
+
+                    # Display list de 8 sprites de 64x64 sobre logo.mem;
+                    # el firmware lo actualiza en vsync (comando sprite).
+                    with open("logo.mem") as f:
+                        sprite_data = [int(line.strip(), 16) for line in f if line.strip()]
+
+                    self.submodules.sprites = ClockDomainsRenamer("hdmi")(
+                        SpriteEngine(sprite_data, hres=hres, vres=vres, n_slots=8)
+                    )
+
+                    self.comb += [
+                        self.vtg.source.connect(self.sprites.vtg_sink),
+                        self.sprites.source.connect(self.videophy.sink)
+                    ]
+
+                elif hdmi_pattern == "fb":
+                    from patterns import CharFramebuffer
+
+                    # 1) Instancia el VTG y el PHY HDMI
+                    self.submodules.vtg     = VideoTimingGenerator(default_video_timings=video_mode)
+                    self.submodules.videophy= VideoGowinHDMIPHY(platform.request("hdmi"),
+                                                                clock_domain="hdmi")
+
+                    # 2) Scanout de caracteres desde HyperRAM (demo "donut hdmi").
+                    #    El buffer vive a 2 MB dentro de main_ram; la CPU solo
+                    #    escribe los 1760 bytes del frame ahi.
+                    self.submodules.fb = CharFramebuffer(
+                        base_addr=self.mem_map["main_ram"] + 0x200000)
+                    self.bus.add_master(name="fb_dma", master=self.fb.bus)
+
+                    # 3) Conecta toda la cadena (vtg/source corren en hdmi, el
+                    #    fetch Wishbone corre en sys dentro del propio modulo).
+                    self.comb += [
+                        self.vtg.source.connect(self.fb.vtg_sink),
+                        self.fb.source.connect(self.videophy.sink),
+                    ]
+
                 elif hdmi_pattern == "tilemap":
                     from patterns import TilemapRenderer
 
                     # 1) Instancia el VTG y el PHY HDMI
-                    self.submodules.vtg     = VideoTimingGenerator(default_video_timings="640x480@60Hz")
+                    self.submodules.vtg     = VideoTimingGenerator(default_video_timings=video_mode)
                     self.submodules.videophy= VideoGowinHDMIPHY(platform.request("hdmi"),
                                                                 clock_domain="hdmi")
 
-                    # 2) Después, carga tu tiles.mem y crea el renderer
+                    # 2) Después, carga tu tiles.mem y crea el renderer.
+                    #    Con palette.mem presente, tiles.mem son indices.
                     with open("tiles.mem") as f:
                         tile_rgb_data = [int(l.strip(), 16) for l in f if l.strip()]
+                    palette_data = None
+                    if os.path.exists("palette.mem"):
+                        with open("palette.mem") as f:
+                            palette_data = [int(l.strip(), 16) for l in f if l.strip()]
 
-                    self.submodules.bars = ClockDomainsRenamer("hdmi")(
+                    self.submodules.tilemap = ClockDomainsRenamer("hdmi")(
                         TilemapRenderer(
                             tile_rgb_data,
-                            screen_w=640, screen_h=480,
-                            tile_w=16,   tile_h=16
+                            screen_w=hres, screen_h=vres,
+                            tile_w=16,   tile_h=16,
+                            palette_data=palette_data
                         )
                     )
 
@@ -195,13 +311,33 @@ class BaseSoC(SoCCore):
                     self.sync.hdmi += vsync_shifted.eq(self.vtg.source.vsync)
 
                     self.comb += [
-                        self.vtg.source.connect(self.bars.vtg_sink, omit={"vsync"}),
-                        self.bars.vtg_sink.vsync.eq(vsync_shifted),
-                        self.bars.source.connect(self.videophy.sink),
+                        self.vtg.source.connect(self.tilemap.vtg_sink, omit={"vsync"}),
+                        self.tilemap.vtg_sink.vsync.eq(vsync_shifted),
+                        self.tilemap.source.connect(self.videophy.sink),
                     ]
                 else:
                     raise ValueError("Unsupported HDMI pattern: {}".format(hdmi_pattern))
 
+        # Contadores de rendimiento: la superficie de observabilidad contra
+        # la que se validan las optimizaciones (comando "stats" del firmware).
+        from patterns import PerfCounters
+        self.perf = PerfCounters()
+        if hasattr(self, "vtg"):
+            self.perf.add_event("frames", self.vtg.source.vsync, edge=True, cdc=True,
+                description="Frames HDMI emitidos (flancos de vsync).")
+        if hasattr(self, "hyperram"):
+            hr = self.hyperram.bus
+            self.perf.add_event("hram_stall", hr.cyc & hr.stb & ~hr.ack,
+                description="Ciclos de bus parados esperando a la HyperRAM.")
+        if hasattr(self, "spiflash_core"):
+            fl = self.spiflash_core.bus
+            self.perf.add_event("flash_reads", fl.ack & ~fl.we,
+                description="Lecturas Wishbone servidas por la flash SPI (XIP).")
+        if hasattr(self, "uart_phy"):
+            self.perf.add_event("uart_tx",
+                self.uart_phy.sink.valid & self.uart_phy.sink.ready,
+                description="Bytes entregados al PHY UART.")
+
         if with_led_chaser:
             self.leds = LedChaser(
                 pads=platform.request_all("user_led"),
@@ -216,7 +352,11 @@ def main():
     parser.add_target_argument("--with-spi-sdcard", action="store_true", help="Enable SPI-mode SDCard support.")
     parser.add_target_argument("--with-video-terminal", action="store_true", help="Enable Video Terminal (HDMI).")
     parser.add_target_argument("--prog-kit", default="openfpgaloader", help="Programmer select from Gowin/openFPGALoader.")
-    parser.add_target_argument("--hdmi-pattern", default="bars", choices=["bars", "sprite","c","tilemap"], help="HDMI pattern to display.")
+    parser.add_target_argument("--hdmi-pattern", default="bars", choices=["bars", "sprite","sprites","c","tilemap","fb"], help="HDMI pattern to display.")
+    parser.add_target_argument("--video-mode", default="640x480@60Hz", choices=list(video_modes), help="Video mode (VTG timings, PLL and renderer geometry).")
+    parser.add_target_argument("--flash-clk-freq", default=27e6, type=float, help="SPI Flash clock frequency.")
+    parser.add_target_argument("--flash-cache-size", default=512, type=int, help="XIP cache size in bytes (0 to disable).")
+    parser.add_target_argument("--hyperram-cache-lines", default=4, type=int, help="HyperRAM line-cache lines of 32 bytes (0 to disable).")
     args = parser.parse_args()
 
     soc = BaseSoC(
@@ -225,6 +365,10 @@ def main():
         bios_flash_offset=int(args.bios_flash_offset, 0),
         with_video_terminal=args.with_video_terminal,
         hdmi_pattern=args.hdmi_pattern,
+        video_mode=args.video_mode,
+        flash_clk_freq=args.flash_clk_freq,
+        flash_cache_size=args.flash_cache_size,
+        hyperram_cache_lines=args.hyperram_cache_lines,
         **parser.soc_argdict
     )
 
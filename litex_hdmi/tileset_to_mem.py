@@ -1,7 +1,8 @@
 from PIL import Image
 import argparse
 
-def tileset_to_mem(input_path, tile_width=16, tile_height=16, output_path="tiles.mem"):
+def tileset_to_mem(input_path, tile_width=16, tile_height=16, output_path="tiles.mem",
+                   palette_path=None):
     img = Image.open(input_path).convert("RGB")
     img_w, img_h = img.size
 
@@ -11,6 +12,10 @@ def tileset_to_mem(input_path, tile_width=16, tile_height=16, output_path="tiles
 
     print(f"[✓] Tiles: {tiles_x} x {tiles_y} = {total_tiles} tiles")
 
+    # Modo paleta: tiles como indices de 8 bits + palette.mem de 24 bits.
+    # Mismo contenido visual con un tercio de la BRAM (ver PaletteRAM).
+    palette = {} if palette_path else None
+
     with open(output_path, "w") as f:
         for ty in range(tiles_y):
             for tx in range(tiles_x):
@@ -18,15 +23,33 @@ def tileset_to_mem(input_path, tile_width=16, tile_height=16, output_path="tiles
                     for x in range(tile_width):
                         px = img.getpixel((tx*tile_width + x, ty*tile_height + y))
                         rgb = (px[0] << 16) | (px[1] << 8) | px[2]
-                        f.write(f"{rgb:06x}\n")
+                        if palette is None:
+                            f.write(f"{rgb:06x}\n")
+                        else:
+                            if rgb not in palette:
+                                if len(palette) >= 256:
+                                    raise SystemExit(
+                                        "[x] Mas de 256 colores: reduce la "
+                                        "imagen o usa el modo RGB directo")
+                                palette[rgb] = len(palette)
+                            f.write(f"{palette[rgb]:02x}\n")
     print(f"[✓] Generado: {output_path}")
 
+    if palette is not None:
+        with open(palette_path, "w") as f:
+            for rgb in palette:  # dict preserva orden de insercion
+                f.write(f"{rgb:06x}\n")
+        print(f"[✓] Generado: {palette_path} ({len(palette)} colores)")
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="Convierte tileset PNG a .mem")
     parser.add_argument("input", help="Archivo PNG del tileset")
     parser.add_argument("--tile_w", type=int, default=16, help="Ancho del tile")
     parser.add_argument("--tile_h", type=int, default=16, help="Alto del tile")
     parser.add_argument("--output", default="tiles.mem", help="Archivo de salida .mem")
+    parser.add_argument("--palette", nargs="?", const="palette.mem", default=None,
+                        help="Modo indexado: escribe indices en --output y la paleta aqui")
     args = parser.parse_args()
 
-    tileset_to_mem(args.input, args.tile_w, args.tile_h, args.output)
+    tileset_to_mem(args.input, args.tile_w, args.tile_h, args.output,
+                   palette_path=args.palette)
@@ -0,0 +1,231 @@
+// Native asset converter for the HDMI demos: replaces the per-pixel PIL
+// loops in tileset_to_mem.py / logo_creation.py with a single mmap'd pass,
+// so converting the big tilesets takes milliseconds instead of minutes.
+//
+// Input is binary PPM (P6); decode PNGs first with e.g.
+//     pngtopnm tileset.png > tileset.ppm
+//
+// Usage:
+//     mem_convert tileset <in.ppm> [-o tiles.mem] [--tile-w N] [--tile-h N]
+//                 [--palette [palette.mem]]
+//     mem_convert logo    <in.ppm> [-o logo.mem] [--bg RRGGBB]
+//
+// Output formats match the Python tools exactly: one lowercase hex value
+// per line, 6 digits for RGB, 2 digits for palette indices; tiles are
+// emitted tile-row by tile-row, row-major inside each tile.
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct Image {
+	const uint8_t *pixels; // packed RGB, 3 bytes per pixel
+	int w, h;
+	const uint8_t *map_base;
+	size_t map_size;
+};
+
+[[noreturn]] void die(const char *fmt, const char *arg = nullptr)
+{
+	fprintf(stderr, "mem_convert: ");
+	fprintf(stderr, fmt, arg);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+// Minimal P6 parser over the mapped file: "P6 <w> <h> <maxval>\n" with
+// optional '#' comments, followed by raw RGB triples.
+Image load_ppm(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		die("cannot open '%s'", path);
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || st.st_size < 16)
+		die("'%s' is not a PPM file", path);
+
+	const uint8_t *base = static_cast<const uint8_t *>(
+		mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+	close(fd);
+	if (base == MAP_FAILED)
+		die("mmap of '%s' failed", path);
+
+	const uint8_t *p   = base;
+	const uint8_t *end = base + st.st_size;
+	if (p[0] != 'P' || p[1] != '6')
+		die("'%s': only binary PPM (P6) is supported "
+		    "(convert with pngtopnm)", path);
+	p += 2;
+
+	long fields[3]; // width, height, maxval
+	for (int i = 0; i < 3; i++) {
+		while (p < end && (isspace(*p) || *p == '#')) {
+			if (*p == '#')
+				while (p < end && *p != '\n')
+					p++;
+			else
+				p++;
+		}
+		char *next;
+		fields[i] = strtol(reinterpret_cast<const char *>(p), &next, 10);
+		if (reinterpret_cast<const uint8_t *>(next) == p)
+			die("'%s': malformed PPM header", path);
+		p = reinterpret_cast<const uint8_t *>(next);
+	}
+	p++; // single whitespace byte after maxval
+
+	Image img;
+	img.w = static_cast<int>(fields[0]);
+	img.h = static_cast<int>(fields[1]);
+	if (fields[2] != 255)
+		die("'%s': only 8-bit PPMs are supported", path);
+	if (end - p < static_cast<long>(3) * img.w * img.h)
+		die("'%s': truncated pixel data", path);
+	img.pixels   = p;
+	img.map_base = base;
+	img.map_size = st.st_size;
+	return img;
+}
+
+inline uint32_t pixel_at(const Image &img, int x, int y)
+{
+	const uint8_t *px = img.pixels + 3*(static_cast<size_t>(y)*img.w + x);
+	return (static_cast<uint32_t>(px[0]) << 16) |
+	       (static_cast<uint32_t>(px[1]) <<  8) |
+	        static_cast<uint32_t>(px[2]);
+}
+
+int convert_tileset(const Image &img, const char *out_path,
+                    int tile_w, int tile_h, const char *palette_path)
+{
+	int tiles_x = img.w / tile_w;
+	int tiles_y = img.h / tile_h;
+
+	FILE *out = fopen(out_path, "w");
+	if (!out)
+		die("cannot write '%s'", out_path);
+
+	// Palette mode: first-seen order, same as the Python dict.
+	uint32_t pal_colors[256];
+	int pal_count = 0;
+
+	for (int ty = 0; ty < tiles_y; ty++)
+	for (int tx = 0; tx < tiles_x; tx++)
+	for (int y = 0; y < tile_h; y++)
+	for (int x = 0; x < tile_w; x++) {
+		uint32_t rgb = pixel_at(img, tx*tile_w + x, ty*tile_h + y);
+		if (!palette_path) {
+			fprintf(out, "%06x\n", rgb);
+			continue;
+		}
+		int idx = -1;
+		for (int i = 0; i < pal_count; i++) {
+			if (pal_colors[i] == rgb) {
+				idx = i;
+				break;
+			}
+		}
+		if (idx < 0) {
+			if (pal_count >= 256)
+				die("more than 256 colors: reduce the image "
+				    "or use direct RGB mode");
+			pal_colors[pal_count] = rgb;
+			idx = pal_count++;
+		}
+		fprintf(out, "%02x\n", idx);
+	}
+	fclose(out);
+	printf("[ok] tiles: %dx%d = %d -> %s\n",
+	       tiles_x, tiles_y, tiles_x*tiles_y, out_path);
+
+	if (palette_path) {
+		FILE *pal = fopen(palette_path, "w");
+		if (!pal)
+			die("cannot write '%s'", palette_path);
+		for (int i = 0; i < pal_count; i++)
+			fprintf(pal, "%06x\n", pal_colors[i]);
+		fclose(pal);
+		printf("[ok] palette: %d colors -> %s\n", pal_count, palette_path);
+	}
+	return 0;
+}
+
+int convert_logo(const Image &img, const char *out_path, uint32_t bg)
+{
+	FILE *out = fopen(out_path, "w");
+	if (!out)
+		die("cannot write '%s'", out_path);
+
+	for (int y = 0; y < img.h; y++)
+	for (int x = 0; x < img.w; x++) {
+		uint32_t rgb = pixel_at(img, x, y);
+		fprintf(out, "%06x\n", rgb == bg ? 0 : rgb);
+	}
+	fclose(out);
+	printf("[ok] logo: %dx%d -> %s\n", img.w, img.h, out_path);
+	return 0;
+}
+
+[[noreturn]] void usage(void)
+{
+	fprintf(stderr,
+		"usage: mem_convert tileset <in.ppm> [-o tiles.mem]\n"
+		"                   [--tile-w N] [--tile-h N] [--palette [file]]\n"
+		"       mem_convert logo <in.ppm> [-o logo.mem] [--bg RRGGBB]\n");
+	exit(1);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+		usage();
+
+	const char *mode    = argv[1];
+	const char *in_path = argv[2];
+	const char *out_path = nullptr;
+	const char *palette_path = nullptr;
+	int tile_w = 16, tile_h = 16;
+	uint32_t bg = 0;
+
+	for (int i = 3; i < argc; i++) {
+		if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+			out_path = argv[++i];
+		} else if (!strcmp(argv[i], "--tile-w") && i + 1 < argc) {
+			tile_w = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "--tile-h") && i + 1 < argc) {
+			tile_h = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "--palette")) {
+			palette_path = (i + 1 < argc && argv[i+1][0] != '-')
+				? argv[++i] : "palette.mem";
+		} else if (!strcmp(argv[i], "--bg") && i + 1 < argc) {
+			bg = strtoul(argv[++i], nullptr, 16);
+		} else {
+			usage();
+		}
+	}
+
+	Image img = load_ppm(in_path);
+	int ret;
+	if (!strcmp(mode, "tileset"))
+		ret = convert_tileset(img, out_path ? out_path : "tiles.mem",
+		                      tile_w, tile_h, palette_path);
+	else if (!strcmp(mode, "logo"))
+		ret = convert_logo(img, out_path ? out_path : "logo.mem", bg);
+	else
+		usage();
+
+	munmap(const_cast<uint8_t *>(img.map_base), img.map_size);
+	return ret;
+}
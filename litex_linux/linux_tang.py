@@ -113,6 +113,9 @@ def main():
         soc_kwargs["with_pcie"] = True
     if "spiflash" in board.soc_capabilities:
         soc_kwargs["with_spi_flash"] = True
+        # Boot from flash: no block-RAM rom, the rom region is remapped into
+        # the XIP flash window below (see soc.add_flash_boot()).
+        soc_kwargs["integrated_rom_size"] = 0
     if "sata" in board.soc_capabilities:
         soc_kwargs["with_sata"] = True
     if "video_terminal" in board.soc_capabilities:
@@ -133,6 +136,8 @@ def main():
         soc.add_constant(k, v)
 
     # Optional interfaces ----------------------------------------------------------------------------
+    if "spiflash" in board.soc_capabilities:
+        soc.add_flash_boot()
     if "spisdcard" in board.soc_capabilities:
         soc.add_spi_sdcard()
     if "sdcard" in board.soc_capabilities:
@@ -756,6 +756,8 @@ class Sipeed_tang_nano_20k(Board):
         Board.__init__(self, sipeed_tang_nano_20k.BaseSoC, soc_capabilities={
             # Communication
             "serial",
+            # Storage
+            "spiflash",
             "sdcard",
         })
         self.soc_kwargs["ident"] = "My Custom Tang Nano SoC"
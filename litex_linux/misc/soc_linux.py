@@ -13,6 +13,8 @@ from migen import *
 
 from litex.soc.interconnect.csr import *
 
+from litex.soc.integration.soc import SoCRegion
+
 from litex.soc.cores.cpu.vexriscv_smp import VexRiscvSMP
 from litex.soc.cores.gpio    import GPIOOut, GPIOIn
 from litex.soc.cores.spi     import SPIMaster
@@ -55,6 +57,19 @@ def SoCLinux(soc_cls, **kwargs):
         def add_i2c(self):
             self.i2c0 = I2CMaster(self.platform.request("i2c", 0))
 
+        # Flash boot -------------------------------------------------------------------------------
+
+        def add_flash_boot(self, loader_offset=0x00180000, rom_size=0x10000):
+            # XIP rom region inside the SPI flash window: whatever is flashed
+            # at loader_offset (the streaming kernel loader from
+            # software/loader, or the BIOS) executes at reset, the same
+            # scheme the Tang Nano 9K HDMI target uses for its BIOS.
+            self.bus.add_region("rom", SoCRegion(
+                origin = self.bus.regions["spiflash"].origin + loader_offset,
+                size   = rom_size,
+                linker = True))
+            self.cpu.set_reset_address(self.bus.regions["rom"].origin)
+
         # Ethernet configuration -------------------------------------------------------------------
 
         def configure_ethernet(self, remote_ip):
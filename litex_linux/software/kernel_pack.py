@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""
+Empaqueta una imagen de arranque (Image, rv32.dtb, opensbi.bin...) en
+chunks LZ4 para el loader de flash (ver loader/main.c).
+
+Formato "LZ4S": cabecera de 16 bytes {magic "LZ4S", tamano de chunk,
+numero de chunks, tamano original} seguida de, por chunk, {tamano
+comprimido u32, tamano original u32, datos}. Un chunk que no comprime se
+almacena tal cual (comp == orig) y el loader lo copia directo. Cada chunk
+va rellenado a multiplo de 4 bytes para que las cabeceras queden siempre
+alineadas (VexRiscv no soporta cargas desalineadas). Los chunks
+independientes permiten al loader descomprimir en streaming desde la
+ventana XIP sin buffer intermedio.
+
+Reutiliza el compresor LZ4 autocontenido del stub del demo HDMI.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "litex_hdmi", "demo"))
+from lz4_pack import lz4_compress
+
+MAGIC = b"LZ4S"
+CHUNK = 64 * 1024
+
+
+def pack(src_path, out_path, chunk_size=CHUNK):
+    with open(src_path, "rb") as f:
+        data = f.read()
+
+    chunks = []
+    for off in range(0, len(data), chunk_size):
+        blk = data[off:off + chunk_size]
+        comp = lz4_compress(blk)
+        if len(comp) >= len(blk):
+            comp = blk  # almacenado: el loader detecta comp == orig
+        chunks.append((bytes(comp), len(blk)))
+
+    with open(out_path, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("<III", chunk_size, len(chunks), len(data)))
+        for comp, orig in chunks:
+            f.write(struct.pack("<II", len(comp), orig))
+            f.write(comp)
+            f.write(b"\x00" * (-len(comp) % 4))  # cabeceras alineadas a 4
+
+    total = os.path.getsize(out_path)
+    print(f"[✓] {src_path}: {len(data)} -> {total} bytes "
+          f"({100*total//max(len(data),1)}%), {len(chunks)} chunks")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Empaqueta imagenes de arranque en chunks LZ4")
+    parser.add_argument("input", help="Imagen de entrada (Image, dtb, opensbi...)")
+    parser.add_argument("output", help="Archivo .lz4s de salida")
+    parser.add_argument("--chunk", type=lambda x: int(x, 0), default=CHUNK,
+                        help="Tamano de chunk en bytes (default 64K)")
+    args = parser.parse_args()
+    pack(args.input, args.output, args.chunk)
+
+
+if __name__ == "__main__":
+    main()
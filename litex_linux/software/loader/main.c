@@ -0,0 +1,212 @@
+// Streaming kernel loader: runs XIP from the rom region in SPI flash and
+// inflates the LZ4S-packed boot images (kernel, dtb, opensbi — built with
+// ../kernel_pack.py) straight from the memory-mapped flash window into
+// HyperRAM. Decoding reads the flash bytes on demand, so the (slow) flash
+// fetch overlaps with decompression and no staging buffer is needed; boot
+// only transfers the compressed sizes. Load time is reported per image.
+//
+// libc-free on purpose: linked with crt0 + this file only (see loader.ld).
+
+#include <stdint.h>
+
+#include <generated/csr.h>
+#include <generated/mem.h>
+#include <generated/soc.h>
+
+/* Flash layout (offsets into the SPI flash, override from the Makefile).
+ * Load addresses mirror boot.json: Image @ +0, dtb @ +0x780000, opensbi
+ * @ +0x7c0000 from the start of main ram. */
+#ifndef KERNEL_FLASH_OFFSET
+#define KERNEL_FLASH_OFFSET  0x00200000
+#endif
+#ifndef DTB_FLASH_OFFSET
+#define DTB_FLASH_OFFSET     0x00700000
+#endif
+#ifndef OPENSBI_FLASH_OFFSET
+#define OPENSBI_FLASH_OFFSET 0x00740000
+#endif
+
+#define KERNEL_ADDR  (MAIN_RAM_BASE + 0x00000000)
+#define DTB_ADDR     (MAIN_RAM_BASE + 0x00780000)
+#define OPENSBI_ADDR (MAIN_RAM_BASE + 0x007c0000)
+
+#define LZ4S_MAGIC 0x53345a4c /* "LZ4S" little-endian */
+
+struct lz4s_header {
+	uint32_t magic;
+	uint32_t chunk_size;
+	uint32_t nchunks;
+	uint32_t orig_size;
+};
+
+int main(void);
+
+/*-----------------------------------------------------------------------*/
+/* Console (raw CSR, no libc)                                            */
+/*-----------------------------------------------------------------------*/
+
+static void putc_raw(char c)
+{
+#ifdef CSR_UART_BASE
+	while(uart_txfull_read());
+	uart_rxtx_write(c);
+#else
+	(void)c;
+#endif
+}
+
+static void puts_raw(const char *s)
+{
+	while(*s)
+		putc_raw(*s++);
+}
+
+static void putdec(uint32_t v)
+{
+	char buf[11];
+	int i = 0;
+
+	do {
+		buf[i++] = '0' + (v % 10);
+		v /= 10;
+	} while(v);
+	while(i--)
+		putc_raw(buf[i]);
+}
+
+static uint32_t rdcycle(void)
+{
+	uint32_t cycles;
+	__asm__ volatile("rdcycle %0" : "=r"(cycles));
+	return cycles;
+}
+
+/*-----------------------------------------------------------------------*/
+/* LZ4S streaming reader                                                 */
+/*-----------------------------------------------------------------------*/
+
+/* Minimal LZ4 block decoder (matches lz4_pack.py). */
+static uint32_t lz4_decompress(const uint8_t *src, uint32_t src_len, uint8_t *dst)
+{
+	const uint8_t *end = src + src_len;
+	uint8_t *d = dst;
+
+	while(src < end) {
+		uint8_t token = *src++;
+		uint32_t len = token >> 4;
+
+		if(len == 15) {
+			uint8_t x;
+			do { x = *src++; len += x; } while(x == 255);
+		}
+		while(len--)
+			*d++ = *src++;
+		if(src >= end)
+			break;  /* final sequence: literals only */
+
+		uint32_t offset = src[0] | (src[1] << 8);
+		src += 2;
+		len = (token & 15) + 4;
+		if((token & 15) == 15) {
+			uint8_t x;
+			do { x = *src++; len += x; } while(x == 255);
+		}
+		{
+			const uint8_t *m = d - offset;
+			while(len--)
+				*d++ = *m++;  /* byte copy: offsets may overlap */
+		}
+	}
+	return d - dst;
+}
+
+/* Inflates one LZ4S image from the XIP window into ram. Chunks are
+ * independent, each prefixed {comp_size, orig_size}; a stored chunk
+ * (comp == orig) is copied as-is. kernel_pack.py pads every chunk to a
+ * 4-byte boundary so the header words stay aligned (VexRiscv has no
+ * misaligned loads). Returns the image size, or -1 if the magic is
+ * missing or a chunk inflates to the wrong size. */
+static int32_t load_lz4s(const char *name, uint32_t flash_offset, uint8_t *dst)
+{
+	const uint8_t *src = (const uint8_t *)(SPIFLASH_BASE + flash_offset);
+	const struct lz4s_header *hdr = (const struct lz4s_header *)src;
+	uint8_t *d = dst;
+	uint32_t t0, ms;
+	uint32_t i;
+
+	if(hdr->magic != LZ4S_MAGIC) {
+		puts_raw(name);
+		puts_raw(": no LZ4S image found.\n");
+		return -1;
+	}
+
+	t0 = rdcycle();
+	src += sizeof(struct lz4s_header);
+	for(i = 0; i < hdr->nchunks; i++) {
+		uint32_t comp_size = ((const uint32_t *)src)[0];
+		uint32_t orig_size = ((const uint32_t *)src)[1];
+		src += 8;
+
+		if(comp_size == orig_size) {
+			/* stored chunk: plain copy from the flash window */
+			const uint8_t *s = src;
+			uint32_t n = orig_size;
+			while(n--)
+				*d++ = *s++;
+		} else {
+			if(lz4_decompress(src, comp_size, d) != orig_size) {
+				puts_raw(name);
+				puts_raw(": corrupt chunk, aborting.\n");
+				return -1;
+			}
+			d += orig_size;
+		}
+		/* skip payload + alignment padding (see kernel_pack.py) */
+		src += (comp_size + 3) & ~(uint32_t)3;
+	}
+	ms = (rdcycle() - t0)/(CONFIG_CLOCK_FREQUENCY/1000);
+
+	puts_raw(name);
+	puts_raw(": ");
+	putdec(hdr->orig_size);
+	puts_raw(" bytes in ");
+	putdec(ms);
+	puts_raw(" ms (");
+	putdec(ms ? hdr->orig_size/ms : 0);
+	puts_raw(" KB/s)\n");
+	return (int32_t)(d - dst);
+}
+
+/*-----------------------------------------------------------------------*/
+/* Boot                                                                  */
+/*-----------------------------------------------------------------------*/
+
+int main(void)
+{
+	/* opensbi expects a0 = hartid, a1 = dtb address. */
+	void (*opensbi)(uint32_t, uint32_t) = (void (*)(uint32_t, uint32_t))OPENSBI_ADDR;
+
+	puts_raw("\nLZ4S flash loader\n");
+
+	if(load_lz4s("kernel ", KERNEL_FLASH_OFFSET,  (uint8_t *)KERNEL_ADDR)  < 0)
+		goto fail;
+	if(load_lz4s("dtb    ", DTB_FLASH_OFFSET,     (uint8_t *)DTB_ADDR)     < 0)
+		goto fail;
+	if(load_lz4s("opensbi", OPENSBI_FLASH_OFFSET, (uint8_t *)OPENSBI_ADDR) < 0)
+		goto fail;
+
+	puts_raw("Jumping to opensbi...\n");
+#ifdef __riscv
+	__asm__ volatile("fence.i");
+#endif
+	opensbi(0, DTB_ADDR);
+
+fail:
+	/* bad/missing images: spin so the message stays on the console */
+	for(;;);
+	return 0;
+}
+
+/* crt0 needs an isr symbol; the loader runs with interrupts off. */
+void isr(void);
+void isr(void) {}